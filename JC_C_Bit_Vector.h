@@ -0,0 +1,480 @@
+#ifndef JC_C_BIT_VECTOR_H_FILE
+#define JC_C_BIT_VECTOR_H_FILE
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "JC_C_Vector.h"
+
+#define JC_C_BIT_VECTOR_WORD_BITS 64
+#define JC_C_BIT_VECTOR_WORDS(bits) (((bits) + JC_C_BIT_VECTOR_WORD_BITS - 1) / JC_C_BIT_VECTOR_WORD_BITS)
+#define JC_C_BIT_VECTOR_GROW_VECTOR(vector) JC_bit_vector_reserve(vector, vector->capacity * JC_C_VECTOR_RESIZE_FACTOR)
+
+#define JC_C_BIT_VECTOR_MIN_BITS 64
+
+// Bit vectors have their own limit instead of JC_C_VECTOR_MAX_SIZE, since sets of flags are often far longer than a
+// vector of elements would be. Counted in bits
+#if SIZE_MAX > UINT32_MAX
+#define JC_C_BIT_VECTOR_MAX_BITS ((size_t)1 << 34)
+#else
+#define JC_C_BIT_VECTOR_MAX_BITS ((size_t)1 << 31)
+#endif
+
+
+
+
+// Bits are packed 64 to a word. Every bit at an index of allocated or above is kept at 0,
+// which lets popcount, find and the word-wide operations work on whole words without masking
+typedef struct JC_Bit_Vector
+{
+	size_t capacity;
+	size_t allocated;
+
+	uint64_t* data;
+
+
+}
+JC_Bit_Vector;
+
+
+
+
+
+
+// ---------------------------------------------------------------------------
+//							Setup and Cleanup
+// ---------------------------------------------------------------------------
+
+static inline JC_Bit_Vector* JC_bit_vector_construct(size_t size)
+{
+	JC_Bit_Vector* new_vector = malloc(sizeof(JC_Bit_Vector));
+
+	if (new_vector == NULL)
+	{
+		return NULL;
+	}
+
+	if (size < JC_C_BIT_VECTOR_MIN_BITS)
+	{
+		size = JC_C_BIT_VECTOR_MIN_BITS;
+	}
+
+	// checked before rounding up to words, which would wrap for sizes near SIZE_MAX
+	if (size > JC_C_BIT_VECTOR_MAX_BITS)
+	{
+		free(new_vector);
+		return NULL;
+	}
+
+	size_t words = JC_C_BIT_VECTOR_WORDS(size);
+
+	new_vector->capacity = words * JC_C_BIT_VECTOR_WORD_BITS;
+	new_vector->allocated = 0;
+	new_vector->data = calloc(words, sizeof(uint64_t));
+
+	if (new_vector->data == NULL)
+	{
+		free(new_vector);
+		return NULL;
+	}
+
+	return new_vector;
+}
+
+static inline void JC_bit_vector_destruct(JC_Bit_Vector** const restrict vector)
+{
+	if (vector == NULL || *vector == NULL)
+		return;
+
+	free((*vector)->data);
+
+	free(*vector);
+	*vector = NULL;
+}
+
+
+
+
+
+
+// --------------------------------------------------------------------------------
+//									Element Access
+// --------------------------------------------------------------------------------
+
+static inline bool JC_bit_vector_get(const JC_Bit_Vector* const restrict vector, const size_t index)
+{
+	if (index >= vector->allocated)
+		return false;
+
+	return (vector->data[index / JC_C_BIT_VECTOR_WORD_BITS] >> (index % JC_C_BIT_VECTOR_WORD_BITS)) & 1;
+}
+
+
+static inline bool JC_bit_vector_set(JC_Bit_Vector* const restrict vector, const size_t index, const bool value)
+{
+	if (index >= vector->allocated)
+		return false;
+
+	uint64_t mask = (uint64_t)1 << (index % JC_C_BIT_VECTOR_WORD_BITS);
+
+	if (value)
+		vector->data[index / JC_C_BIT_VECTOR_WORD_BITS] |= mask;
+	else
+		vector->data[index / JC_C_BIT_VECTOR_WORD_BITS] &= ~mask;
+
+	return true;
+}
+
+
+static inline uint64_t* JC_bit_vector_data(const JC_Bit_Vector* const restrict vector)
+{
+	return vector->data;
+}
+
+
+
+
+
+
+// -----------------------------------------------------------------------------
+//									Capacity
+// -----------------------------------------------------------------------------
+
+static inline bool JC_bit_vector_empty(const JC_Bit_Vector* const restrict vector)
+{
+	return !vector->allocated;
+}
+
+static inline size_t JC_bit_vector_size(const JC_Bit_Vector* const restrict vector)
+{
+	return vector->allocated;
+}
+
+static inline size_t JC_bit_vector_capacity(const JC_Bit_Vector* const restrict vector)
+{
+	return vector->capacity;
+}
+
+
+static inline bool JC_bit_vector_reserve(JC_Bit_Vector* const restrict vector, const size_t size)
+{
+	if (size <= vector->capacity)
+		return true;
+
+	if (size > JC_C_BIT_VECTOR_MAX_BITS)
+		return false;
+
+	size_t words = JC_C_BIT_VECTOR_WORDS(size);
+	size_t old_words = vector->capacity / JC_C_BIT_VECTOR_WORD_BITS;
+
+
+	uint64_t* temp_data = realloc(vector->data, words * sizeof(uint64_t));
+
+	if (temp_data == NULL) {
+		return false;
+	}
+
+	// new words have to start cleared to keep every bit past allocated at 0
+	memset(temp_data + old_words, 0, (words - old_words) * sizeof(uint64_t));
+
+	vector->data = temp_data;
+	vector->capacity = words * JC_C_BIT_VECTOR_WORD_BITS;
+
+	return true;
+}
+
+
+
+
+
+
+// -----------------------------------------------------------------------------
+//									Modifiers
+// -----------------------------------------------------------------------------
+
+static inline void JC_bit_vector_clear(JC_Bit_Vector* const restrict vector)
+{
+	memset(vector->data, 0, JC_C_BIT_VECTOR_WORDS(vector->allocated) * sizeof(uint64_t));
+	vector->allocated = 0;
+}
+
+
+static inline bool JC_bit_vector_pushback(JC_Bit_Vector* const restrict vector, const bool value)
+{
+	if (vector->allocated == vector->capacity)
+	{
+		if (JC_C_BIT_VECTOR_GROW_VECTOR(vector) == JC_C_VECTOR_GROW_FAILURE)
+		{
+			return false;
+		}
+	}
+
+	vector->data[vector->allocated / JC_C_BIT_VECTOR_WORD_BITS] |= (uint64_t)value << (vector->allocated % JC_C_BIT_VECTOR_WORD_BITS);
+	vector->allocated++;
+
+	return true;
+}
+
+
+static inline void JC_bit_vector_pop_back(JC_Bit_Vector* const restrict vector)
+{
+	if (vector->allocated == 0)
+		return;
+
+	vector->allocated--;
+	vector->data[vector->allocated / JC_C_BIT_VECTOR_WORD_BITS] &= ~((uint64_t)1 << (vector->allocated % JC_C_BIT_VECTOR_WORD_BITS));
+}
+
+
+static inline bool JC_bit_vector_insert(JC_Bit_Vector* const restrict vector, const size_t index, const bool value)
+{
+	if (index > vector->allocated)
+		return false;
+
+	if (vector->allocated == vector->capacity)
+	{
+		if (JC_C_BIT_VECTOR_GROW_VECTOR(vector) == JC_C_VECTOR_GROW_FAILURE)
+		{
+			return false;
+		}
+	}
+
+	size_t insert_word = index / JC_C_BIT_VECTOR_WORD_BITS;
+	size_t last_word = vector->allocated / JC_C_BIT_VECTOR_WORD_BITS;
+
+	// move every word above the insertion point up by one bit, carrying the top bit of the word below
+	for (size_t i = last_word; i > insert_word; i--)
+	{
+		vector->data[i] = (vector->data[i] << 1) | (vector->data[i - 1] >> (JC_C_BIT_VECTOR_WORD_BITS - 1));
+	}
+
+	uint64_t low_mask = ((uint64_t)1 << (index % JC_C_BIT_VECTOR_WORD_BITS)) - 1;
+	uint64_t word = vector->data[insert_word];
+
+	vector->data[insert_word] = (word & low_mask) | ((word & ~low_mask) << 1) | ((uint64_t)value << (index % JC_C_BIT_VECTOR_WORD_BITS));
+
+	vector->allocated++;
+
+	return true;
+}
+
+
+static inline bool JC_bit_vector_erase(JC_Bit_Vector* const restrict vector, const size_t index)
+{
+	if (index >= vector->allocated)
+		return false;
+
+	size_t erase_word = index / JC_C_BIT_VECTOR_WORD_BITS;
+	size_t last_word = (vector->allocated - 1) / JC_C_BIT_VECTOR_WORD_BITS;
+
+	uint64_t low_mask = ((uint64_t)1 << (index % JC_C_BIT_VECTOR_WORD_BITS)) - 1;
+	uint64_t word = vector->data[erase_word];
+
+	vector->data[erase_word] = (word & low_mask) | ((word >> 1) & ~low_mask);
+
+	// move every word above the erased bit down by one bit, carrying the bottom bit of the word above
+	for (size_t i = erase_word; i < last_word; i++)
+	{
+		vector->data[i] |= vector->data[i + 1] << (JC_C_BIT_VECTOR_WORD_BITS - 1);
+		vector->data[i + 1] >>= 1;
+	}
+
+	vector->allocated--;
+	return true;
+}
+
+
+static inline bool JC_bit_vector_resize(JC_Bit_Vector* const restrict vector, const size_t new_size, const bool value)
+{
+	if (new_size <= vector->allocated)
+	{
+		size_t first_word = JC_C_BIT_VECTOR_WORDS(new_size);
+
+		memset(vector->data + first_word, 0, (JC_C_BIT_VECTOR_WORDS(vector->allocated) - first_word) * sizeof(uint64_t));
+
+		if (new_size % JC_C_BIT_VECTOR_WORD_BITS)
+			vector->data[new_size / JC_C_BIT_VECTOR_WORD_BITS] &= ((uint64_t)1 << (new_size % JC_C_BIT_VECTOR_WORD_BITS)) - 1;
+
+		vector->allocated = new_size;
+		return true;
+	}
+
+	while (new_size > vector->capacity)
+	{
+		if (JC_C_BIT_VECTOR_GROW_VECTOR(vector) == JC_C_VECTOR_GROW_FAILURE)
+			return false;
+	}
+
+	if (value)
+	{
+		// finish off the partially used word bit by bit, then fill the rest a whole word at a time
+		size_t i = vector->allocated;
+
+		for (; i < new_size && i % JC_C_BIT_VECTOR_WORD_BITS; i++)
+			vector->data[i / JC_C_BIT_VECTOR_WORD_BITS] |= (uint64_t)1 << (i % JC_C_BIT_VECTOR_WORD_BITS);
+
+		for (; i + JC_C_BIT_VECTOR_WORD_BITS <= new_size; i += JC_C_BIT_VECTOR_WORD_BITS)
+			vector->data[i / JC_C_BIT_VECTOR_WORD_BITS] = UINT64_MAX;
+
+		if (i < new_size)
+			vector->data[i / JC_C_BIT_VECTOR_WORD_BITS] = ((uint64_t)1 << (new_size - i)) - 1;
+	}
+
+	vector->allocated = new_size;
+	return true;
+}
+
+
+static inline void JC_bit_vector_swap(JC_Bit_Vector** const restrict vector1, JC_Bit_Vector** const restrict vector2)
+{
+	JC_Bit_Vector* temp_ptr = *vector1;
+	*vector1 = *vector2;
+	*vector2 = temp_ptr;
+}
+
+
+
+
+
+
+// --------------------------------------------------------------------------------
+//								Bit Operations
+// --------------------------------------------------------------------------------
+
+static inline size_t JC_bit_vector_popcount_word(uint64_t word)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	return (size_t)__builtin_popcountll(word);
+#else
+	word = word - ((word >> 1) & 0x5555555555555555ULL);
+	word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+	word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+	return (size_t)((word * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+
+static inline size_t JC_bit_vector_count_trailing_zeros(uint64_t word)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	return (size_t)__builtin_ctzll(word);
+#else
+	size_t count = 0;
+	while (!(word & 1))
+	{
+		word >>= 1;
+		count++;
+	}
+	return count;
+#endif
+}
+
+
+static inline size_t JC_bit_vector_popcount(const JC_Bit_Vector* const restrict vector)
+{
+	size_t count = 0;
+	size_t words = JC_C_BIT_VECTOR_WORDS(vector->allocated);
+
+	for (size_t i = 0; i < words; i++)
+		count += JC_bit_vector_popcount_word(vector->data[i]);
+
+	return count;
+}
+
+
+static inline size_t JC_bit_vector_find_next_set(const JC_Bit_Vector* const restrict vector, const size_t index)
+{
+	if (index >= vector->allocated)
+		return vector->allocated;
+
+	size_t words = JC_C_BIT_VECTOR_WORDS(vector->allocated);
+	size_t i = index / JC_C_BIT_VECTOR_WORD_BITS;
+
+	// the first word has the bits below index masked off
+	uint64_t word = vector->data[i] & (UINT64_MAX << (index % JC_C_BIT_VECTOR_WORD_BITS));
+
+	while (word == 0)
+	{
+		if (++i == words)
+			return vector->allocated;
+
+		word = vector->data[i];
+	}
+
+	return i * JC_C_BIT_VECTOR_WORD_BITS + JC_bit_vector_count_trailing_zeros(word);
+}
+
+
+static inline size_t JC_bit_vector_find_first_set(const JC_Bit_Vector* const restrict vector)
+{
+	return JC_bit_vector_find_next_set(vector, 0);
+}
+
+
+static inline size_t JC_bit_vector_find_next_clear(const JC_Bit_Vector* const restrict vector, const size_t index)
+{
+	if (index >= vector->allocated)
+		return vector->allocated;
+
+	size_t words = JC_C_BIT_VECTOR_WORDS(vector->allocated);
+	size_t i = index / JC_C_BIT_VECTOR_WORD_BITS;
+
+	// searching the inverted words turns this into a search for a set bit. The cleared bits past allocated
+	// become set bits, so the result is capped to allocated instead
+	uint64_t word = ~vector->data[i] & (UINT64_MAX << (index % JC_C_BIT_VECTOR_WORD_BITS));
+
+	while (word == 0)
+	{
+		if (++i == words)
+			return vector->allocated;
+
+		word = ~vector->data[i];
+	}
+
+	size_t found = i * JC_C_BIT_VECTOR_WORD_BITS + JC_bit_vector_count_trailing_zeros(word);
+	return found < vector->allocated ? found : vector->allocated;
+}
+
+
+static inline bool JC_bit_vector_and(JC_Bit_Vector* const restrict destination, const JC_Bit_Vector* const restrict source)
+{
+	if (destination->allocated != source->allocated)
+		return false;
+
+	size_t words = JC_C_BIT_VECTOR_WORDS(destination->allocated);
+
+	for (size_t i = 0; i < words; i++)
+		destination->data[i] &= source->data[i];
+
+	return true;
+}
+
+
+static inline bool JC_bit_vector_or(JC_Bit_Vector* const restrict destination, const JC_Bit_Vector* const restrict source)
+{
+	if (destination->allocated != source->allocated)
+		return false;
+
+	size_t words = JC_C_BIT_VECTOR_WORDS(destination->allocated);
+
+	for (size_t i = 0; i < words; i++)
+		destination->data[i] |= source->data[i];
+
+	return true;
+}
+
+
+static inline void JC_bit_vector_not(JC_Bit_Vector* const restrict vector)
+{
+	size_t words = JC_C_BIT_VECTOR_WORDS(vector->allocated);
+
+	for (size_t i = 0; i < words; i++)
+		vector->data[i] = ~vector->data[i];
+
+	// the bits past allocated in the last word got flipped on as well and have to be cleared again
+	if (vector->allocated % JC_C_BIT_VECTOR_WORD_BITS)
+		vector->data[words - 1] &= ((uint64_t)1 << (vector->allocated % JC_C_BIT_VECTOR_WORD_BITS)) - 1;
+}
+
+
+#endif
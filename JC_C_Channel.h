@@ -0,0 +1,234 @@
+#ifndef JC_C_CHANNEL_H_FILE
+#define JC_C_CHANNEL_H_FILE
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <string.h>
+#include "JC_C_Vector.h"
+
+#define JC_C_CHANNEL_CACHE_LINE 64
+
+
+
+
+// A single producer, single consumer ring of capacity slots held in a JC_Vector. head and tail count every slot
+// ever released and committed, and are only reduced to a slot position when indexing, so head == tail means empty.
+// Each side keeps a cached copy of the other side's counter, and only reloads it when the cached copy says it has run
+// out of room, which keeps the two cache lines from bouncing between cores on every call.
+// The padding keeps the consumer's fields, the producer's fields and the shared read only fields on separate cache lines
+typedef struct JC_Channel
+{
+	JC_Vector* storage;
+	size_t capacity;
+	size_t type_size;
+
+	char consumer_padding[JC_C_CHANNEL_CACHE_LINE];
+	atomic_size_t head;
+	size_t cached_tail;
+
+	char producer_padding[JC_C_CHANNEL_CACHE_LINE];
+	atomic_size_t tail;
+	size_t cached_head;
+
+	char end_padding[JC_C_CHANNEL_CACHE_LINE];
+}
+JC_Channel;
+
+
+
+
+
+
+// ---------------------------------------------------------------------------
+//							Setup and Cleanup
+// ---------------------------------------------------------------------------
+
+static inline JC_Channel* JC_channel_construct(size_t capacity, size_t type_size)
+{
+	JC_Channel* new_channel = malloc(sizeof(JC_Channel));
+
+	if (new_channel == NULL)
+	{
+		return NULL;
+	}
+
+	// a power of 2 capacity lets a counter be turned into a slot position with a mask
+	size_t rounded_capacity = 1;
+
+	while (rounded_capacity < capacity)
+		rounded_capacity *= 2;
+
+	new_channel->storage = JC_vector_construct(rounded_capacity, type_size);
+
+	if (new_channel->storage == NULL)
+	{
+		free(new_channel);
+		return NULL;
+	}
+
+	new_channel->capacity = rounded_capacity;
+	new_channel->type_size = type_size;
+	new_channel->cached_tail = 0;
+	new_channel->cached_head = 0;
+	atomic_init(&new_channel->head, 0);
+	atomic_init(&new_channel->tail, 0);
+
+	return new_channel;
+}
+
+static inline void JC_channel_destruct(JC_Channel** const restrict channel)
+{
+	if (channel == NULL || *channel == NULL)
+		return;
+
+	JC_vector_destruct(&(*channel)->storage);
+
+	free(*channel);
+	*channel = NULL;
+}
+
+
+
+
+
+
+// --------------------------------------------------------------------------------
+//									Producer
+// --------------------------------------------------------------------------------
+
+// Returns a pointer to up to count empty slots which can be written in place, and sets reserved to how many there are.
+// Fewer slots than asked for are returned when the ring is nearly full or the free space wraps around the end
+static inline char* JC_channel_reserve(JC_Channel* const restrict channel, const size_t count, size_t* const restrict reserved)
+{
+	size_t tail = atomic_load_explicit(&channel->tail, memory_order_relaxed);
+
+	if (tail - channel->cached_head + count > channel->capacity)
+		channel->cached_head = atomic_load_explicit(&channel->head, memory_order_acquire);
+
+	size_t position = tail & (channel->capacity - 1);
+	size_t free_slots = channel->capacity - (tail - channel->cached_head);
+	size_t until_wrap = channel->capacity - position;
+
+	*reserved = count;
+
+	if (*reserved > free_slots)
+		*reserved = free_slots;
+	if (*reserved > until_wrap)
+		*reserved = until_wrap;
+
+	if (*reserved == 0)
+		return NULL;
+
+	return JC_vector_at_ptr_unsafe(channel->storage, position);
+}
+
+
+// Publishes count slots from the last reserve to the consumer
+static inline void JC_channel_commit(JC_Channel* const restrict channel, const size_t count)
+{
+	size_t tail = atomic_load_explicit(&channel->tail, memory_order_relaxed);
+	atomic_store_explicit(&channel->tail, tail + count, memory_order_release);
+}
+
+
+static inline bool JC_channel_push(JC_Channel* const restrict channel, const void* const restrict value)
+{
+	size_t reserved;
+	char* slot = JC_channel_reserve(channel, 1, &reserved);
+
+	if (slot == NULL)
+		return false;
+
+	memcpy(slot, value, channel->type_size);
+	JC_channel_commit(channel, 1);
+
+	return true;
+}
+
+
+
+
+
+
+// --------------------------------------------------------------------------------
+//									Consumer
+// --------------------------------------------------------------------------------
+
+// Returns a pointer to up to count committed slots which can be read in place, and sets available to how many there are.
+// Fewer slots than asked for are returned when the ring is nearly empty or the committed slots wrap around the end
+static inline char* JC_channel_peek(JC_Channel* const restrict channel, const size_t count, size_t* const restrict available)
+{
+	size_t head = atomic_load_explicit(&channel->head, memory_order_relaxed);
+
+	if (channel->cached_tail - head < count)
+		channel->cached_tail = atomic_load_explicit(&channel->tail, memory_order_acquire);
+
+	size_t position = head & (channel->capacity - 1);
+	size_t used_slots = channel->cached_tail - head;
+	size_t until_wrap = channel->capacity - position;
+
+	*available = count;
+
+	if (*available > used_slots)
+		*available = used_slots;
+	if (*available > until_wrap)
+		*available = until_wrap;
+
+	if (*available == 0)
+		return NULL;
+
+	return JC_vector_at_ptr_unsafe(channel->storage, position);
+}
+
+
+// Hands count slots from the last peek back to the producer. The slots must not be read after this
+static inline void JC_channel_release(JC_Channel* const restrict channel, const size_t count)
+{
+	size_t head = atomic_load_explicit(&channel->head, memory_order_relaxed);
+	atomic_store_explicit(&channel->head, head + count, memory_order_release);
+}
+
+
+static inline bool JC_channel_pop(JC_Channel* const restrict channel, void* const restrict out)
+{
+	size_t available;
+	char* slot = JC_channel_peek(channel, 1, &available);
+
+	if (slot == NULL)
+		return false;
+
+	memcpy(out, slot, channel->type_size);
+	JC_channel_release(channel, 1);
+
+	return true;
+}
+
+
+
+
+
+
+// -----------------------------------------------------------------------------
+//									Capacity
+// -----------------------------------------------------------------------------
+
+// Only exact when called from the producer or consumer thread while the other side is idle
+static inline size_t JC_channel_size(JC_Channel* const restrict channel)
+{
+	// head is loaded first so that it can never be ahead of the tail it's compared against
+	size_t head = atomic_load_explicit(&channel->head, memory_order_acquire);
+	return atomic_load_explicit(&channel->tail, memory_order_acquire) - head;
+}
+
+static inline bool JC_channel_empty(JC_Channel* const restrict channel)
+{
+	return JC_channel_size(channel) == 0;
+}
+
+static inline size_t JC_channel_capacity(const JC_Channel* const restrict channel)
+{
+	return channel->capacity;
+}
+
+
+#endif
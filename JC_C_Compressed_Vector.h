@@ -0,0 +1,378 @@
+#ifndef JC_C_COMPRESSED_VECTOR_H_FILE
+#define JC_C_COMPRESSED_VECTOR_H_FILE
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "JC_C_Vector.h"
+
+// Each block is packed once it is full, so the block size also sets how many values are buffered uncompressed.
+// 128 values of bit_width bits always take exactly 2 * bit_width words, so blocks never share a word
+#define JC_C_COMPRESSED_VECTOR_BLOCK_SIZE 128
+#define JC_C_COMPRESSED_VECTOR_BLOCK_WORDS(bit_width) (2 * (bit_width))
+
+
+
+
+// Frame of reference block. Every value in the block is stored as (value - base) using bit_width bits
+typedef struct JC_Compressed_Block
+{
+	uint64_t base;
+	size_t word_offset;
+	size_t bit_width;
+}
+JC_Compressed_Block;
+
+
+// Values are appended to tail, and once it holds JC_C_COMPRESSED_VECTOR_BLOCK_SIZE values it is packed into a new block.
+// words always ends with two padding words of 0 so that unpacking can unconditionally read the word after a value,
+// even for a block with a bit_width of 0 which takes up no words of its own
+typedef struct JC_Compressed_Vector
+{
+	size_t allocated;
+
+	JC_Vector* blocks;
+	JC_Vector* words;
+
+	size_t tail_count;
+	uint64_t tail[JC_C_COMPRESSED_VECTOR_BLOCK_SIZE];
+
+
+}
+JC_Compressed_Vector;
+
+
+
+
+
+
+// ---------------------------------------------------------------------------
+//							Setup and Cleanup
+// ---------------------------------------------------------------------------
+
+static inline JC_Compressed_Vector* JC_compressed_vector_construct(size_t size)
+{
+	JC_Compressed_Vector* new_vector = malloc(sizeof(JC_Compressed_Vector));
+
+	if (new_vector == NULL)
+	{
+		return NULL;
+	}
+
+	new_vector->allocated = 0;
+	new_vector->tail_count = 0;
+	new_vector->blocks = JC_vector_construct(size / JC_C_COMPRESSED_VECTOR_BLOCK_SIZE, sizeof(JC_Compressed_Block));
+	new_vector->words = JC_vector_construct(0, sizeof(uint64_t));
+
+	uint64_t padding = 0;
+
+	if (new_vector->blocks == NULL || new_vector->words == NULL || !JC_vector_resize_ptr(new_vector->words, 2, &padding))
+	{
+		JC_vector_destruct(&new_vector->blocks);
+		JC_vector_destruct(&new_vector->words);
+		free(new_vector);
+		return NULL;
+	}
+
+	return new_vector;
+}
+
+static inline void JC_compressed_vector_destruct(JC_Compressed_Vector** const restrict vector)
+{
+	if (vector == NULL || *vector == NULL)
+		return;
+
+	JC_vector_destruct(&(*vector)->blocks);
+	JC_vector_destruct(&(*vector)->words);
+
+	free(*vector);
+	*vector = NULL;
+}
+
+
+
+
+
+
+// --------------------------------------------------------------------------------
+//									Packing
+// --------------------------------------------------------------------------------
+
+static inline size_t JC_compressed_vector_bit_width(uint64_t range)
+{
+	size_t bit_width = 0;
+
+	while (range)
+	{
+		bit_width++;
+		range >>= 1;
+	}
+
+	return bit_width;
+}
+
+
+static inline void JC_compressed_vector_pack(const uint64_t* const restrict values, const uint64_t base, const size_t bit_width, uint64_t* const restrict out)
+{
+	memset(out, 0, JC_C_COMPRESSED_VECTOR_BLOCK_WORDS(bit_width) * sizeof(uint64_t));
+
+	if (bit_width == 0)
+		return;
+
+	for (size_t i = 0; i < JC_C_COMPRESSED_VECTOR_BLOCK_SIZE; i++)
+	{
+		uint64_t value = values[i] - base;
+		size_t bit = i * bit_width;
+		size_t shift = bit % 64;
+
+		out[bit / 64] |= value << shift;
+
+		if (shift + bit_width > 64)
+			out[bit / 64 + 1] |= value >> (64 - shift);
+	}
+}
+
+
+// Branch free. The word after the value is always read, which is why every block is followed by either another block or the
+// padding words. (high << 1) << (63 - shift) is used instead of high << (64 - shift) to avoid shifting by 64 when shift is 0
+static inline uint64_t JC_compressed_vector_extract(const uint64_t* const restrict words, const size_t bit, const size_t bit_width)
+{
+	uint64_t mask = bit_width == 64 ? UINT64_MAX : ((uint64_t)1 << bit_width) - 1;
+	uint64_t low = words[bit / 64] >> (bit % 64);
+	uint64_t high = (words[bit / 64 + 1] << 1) << (63 - bit % 64);
+
+	return (low | high) & mask;
+}
+
+
+// The compiler can't vectorize the scalar loop, since every value needs its own shift and word index. With AVX2, 4 values are
+// unpacked at once using a gather for each of the two words a value can span and per lane variable shifts. Shifting a lane
+// left by 64 gives 0 there, so the high word needs none of the care the scalar version takes
+static inline void JC_compressed_vector_unpack(const uint64_t* const restrict words, const uint64_t base, const size_t bit_width, const size_t count, uint64_t* const restrict out)
+{
+	size_t i = 0;
+
+#if defined(__AVX2__) && SIZE_MAX == UINT64_MAX
+	const __m256i mask = _mm256_set1_epi64x((long long)(bit_width == 64 ? UINT64_MAX : ((uint64_t)1 << bit_width) - 1));
+	const __m256i base_lanes = _mm256_set1_epi64x((long long)base);
+	const __m256i step = _mm256_set1_epi64x((long long)(4 * bit_width));
+	__m256i bit = _mm256_set_epi64x((long long)(3 * bit_width), (long long)(2 * bit_width), (long long)bit_width, 0);
+
+	for (; i + 4 <= count; i += 4)
+	{
+		__m256i word_index = _mm256_srli_epi64(bit, 6);
+		__m256i shift = _mm256_and_si256(bit, _mm256_set1_epi64x(63));
+
+		__m256i low = _mm256_i64gather_epi64((const long long*)words, word_index, 8);
+		__m256i high = _mm256_i64gather_epi64((const long long*)words, _mm256_add_epi64(word_index, _mm256_set1_epi64x(1)), 8);
+
+		low = _mm256_srlv_epi64(low, shift);
+		high = _mm256_sllv_epi64(high, _mm256_sub_epi64(_mm256_set1_epi64x(64), shift));
+
+		_mm256_storeu_si256((__m256i*)(out + i), _mm256_add_epi64(base_lanes, _mm256_and_si256(_mm256_or_si256(low, high), mask)));
+		bit = _mm256_add_epi64(bit, step);
+	}
+#endif
+
+	for (; i < count; i++)
+		out[i] = base + JC_compressed_vector_extract(words, i * bit_width, bit_width);
+}
+
+
+static inline bool JC_compressed_vector_flush_tail(JC_Compressed_Vector* const restrict vector)
+{
+	uint64_t min = vector->tail[0];
+	uint64_t max = vector->tail[0];
+
+	for (size_t i = 1; i < JC_C_COMPRESSED_VECTOR_BLOCK_SIZE; i++)
+	{
+		if (vector->tail[i] < min)
+			min = vector->tail[i];
+		if (vector->tail[i] > max)
+			max = vector->tail[i];
+	}
+
+	JC_Compressed_Block block;
+	block.base = min;
+	block.bit_width = JC_compressed_vector_bit_width(max - min);
+	block.word_offset = vector->words->allocated - 2;
+
+	uint64_t packed[JC_C_COMPRESSED_VECTOR_BLOCK_WORDS(64)];
+	JC_compressed_vector_pack(vector->tail, block.base, block.bit_width, packed);
+
+	size_t block_words = JC_C_COMPRESSED_VECTOR_BLOCK_WORDS(block.bit_width);
+
+	// grow both vectors before touching either so a failure leaves the vector unchanged
+	if (vector->blocks->allocated == vector->blocks->capacity)
+	{
+		if (JC_C_VECTOR_GROW_VECTOR(vector->blocks) == JC_C_VECTOR_GROW_FAILURE)
+			return false;
+	}
+
+	while (vector->words->allocated + block_words > vector->words->capacity)
+	{
+		if (JC_C_VECTOR_GROW_VECTOR(vector->words) == JC_C_VECTOR_GROW_FAILURE)
+			return false;
+	}
+
+	// the block takes the place of the padding words, and new padding words go after it
+	vector->words->allocated -= 2;
+
+	for (size_t i = 0; i < block_words; i++)
+		JC_vector_pushback_ptr(vector->words, &packed[i]);
+
+	uint64_t padding = 0;
+	JC_vector_pushback_ptr(vector->words, &padding);
+	JC_vector_pushback_ptr(vector->words, &padding);
+	JC_vector_pushback_ptr(vector->blocks, &block);
+
+	vector->tail_count = 0;
+	return true;
+}
+
+
+
+
+
+
+// --------------------------------------------------------------------------------
+//									Element Access
+// --------------------------------------------------------------------------------
+
+static inline bool JC_compressed_vector_get(const JC_Compressed_Vector* const restrict vector, const size_t index, uint64_t* const restrict value)
+{
+	if (index >= vector->allocated)
+		return false;
+
+	size_t block_index = index / JC_C_COMPRESSED_VECTOR_BLOCK_SIZE;
+
+	if (block_index == vector->blocks->allocated)
+	{
+		*value = vector->tail[index % JC_C_COMPRESSED_VECTOR_BLOCK_SIZE];
+		return true;
+	}
+
+	const JC_Compressed_Block* block = (const JC_Compressed_Block*)JC_vector_at_ptr_unsafe(vector->blocks, block_index);
+	const uint64_t* words = (const uint64_t*)JC_vector_at_ptr_unsafe(vector->words, block->word_offset);
+
+	*value = block->base + JC_compressed_vector_extract(words, (index % JC_C_COMPRESSED_VECTOR_BLOCK_SIZE) * block->bit_width, block->bit_width);
+
+	return true;
+}
+
+
+static inline size_t JC_compressed_vector_decode_block(const JC_Compressed_Vector* const restrict vector, const size_t block_index, uint64_t* const restrict out)
+{
+	if (block_index > vector->blocks->allocated)
+		return 0;
+
+	if (block_index == vector->blocks->allocated)
+	{
+		memcpy(out, vector->tail, vector->tail_count * sizeof(uint64_t));
+		return vector->tail_count;
+	}
+
+	const JC_Compressed_Block* block = (const JC_Compressed_Block*)JC_vector_at_ptr_unsafe(vector->blocks, block_index);
+
+	JC_compressed_vector_unpack((const uint64_t*)JC_vector_at_ptr_unsafe(vector->words, block->word_offset), block->base, block->bit_width, JC_C_COMPRESSED_VECTOR_BLOCK_SIZE, out);
+
+	return JC_C_COMPRESSED_VECTOR_BLOCK_SIZE;
+}
+
+
+static inline bool JC_compressed_vector_decode(const JC_Compressed_Vector* const restrict vector, size_t start, size_t count, uint64_t* restrict out)
+{
+	if (start > vector->allocated || count > vector->allocated - start)
+		return false;
+
+	uint64_t block_values[JC_C_COMPRESSED_VECTOR_BLOCK_SIZE];
+
+	while (count > 0)
+	{
+		// whole aligned blocks are decoded straight into out, anything else goes through block_values
+		size_t offset = start % JC_C_COMPRESSED_VECTOR_BLOCK_SIZE;
+		bool direct = offset == 0 && count >= JC_C_COMPRESSED_VECTOR_BLOCK_SIZE;
+
+		size_t decoded = JC_compressed_vector_decode_block(vector, start / JC_C_COMPRESSED_VECTOR_BLOCK_SIZE, direct ? out : block_values);
+		size_t copy_count = decoded - offset < count ? decoded - offset : count;
+
+		if (!direct)
+			memcpy(out, block_values + offset, copy_count * sizeof(uint64_t));
+
+		out += copy_count;
+		start += copy_count;
+		count -= copy_count;
+	}
+
+	return true;
+}
+
+
+
+
+
+
+// -----------------------------------------------------------------------------
+//									Capacity
+// -----------------------------------------------------------------------------
+
+static inline bool JC_compressed_vector_empty(const JC_Compressed_Vector* const restrict vector)
+{
+	return !vector->allocated;
+}
+
+static inline size_t JC_compressed_vector_size(const JC_Compressed_Vector* const restrict vector)
+{
+	return vector->allocated;
+}
+
+static inline size_t JC_compressed_vector_block_count(const JC_Compressed_Vector* const restrict vector)
+{
+	return vector->blocks->allocated + (vector->tail_count != 0);
+}
+
+static inline size_t JC_compressed_vector_compressed_bytes(const JC_Compressed_Vector* const restrict vector)
+{
+	return vector->blocks->allocated * sizeof(JC_Compressed_Block)
+		+ vector->words->allocated * sizeof(uint64_t)
+		+ vector->tail_count * sizeof(uint64_t);
+}
+
+
+
+
+
+
+// -----------------------------------------------------------------------------
+//									Modifiers
+// -----------------------------------------------------------------------------
+
+static inline void JC_compressed_vector_clear(JC_Compressed_Vector* const restrict vector)
+{
+	JC_vector_clear(vector->blocks);
+	uint64_t padding = 0;
+	JC_vector_clear(vector->words);
+	JC_vector_resize_ptr(vector->words, 2, &padding);
+
+	vector->tail_count = 0;
+	vector->allocated = 0;
+}
+
+
+static inline bool JC_compressed_vector_pushback(JC_Compressed_Vector* const restrict vector, const uint64_t value)
+{
+	if (vector->tail_count == JC_C_COMPRESSED_VECTOR_BLOCK_SIZE)
+	{
+		if (!JC_compressed_vector_flush_tail(vector))
+			return false;
+	}
+
+	vector->tail[vector->tail_count] = value;
+	vector->tail_count++;
+	vector->allocated++;
+
+	return true;
+}
+
+
+#endif
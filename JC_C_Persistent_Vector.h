@@ -0,0 +1,413 @@
+#ifndef JC_C_PERSISTENT_VECTOR_H_FILE
+#define JC_C_PERSISTENT_VECTOR_H_FILE
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdatomic.h>
+#include <string.h>
+#include "JC_C_Vector.h"
+
+#define JC_C_PERSISTENT_VECTOR_CHUNK_ELEMENTS 256
+
+
+
+
+// A fixed size run of elements which may be shared between several versions. Only the version owned by the writer
+// ever writes into a chunk, and only once it holds the sole reference to it
+typedef struct JC_Persistent_Chunk
+{
+	atomic_size_t references;
+	_Alignas(max_align_t) char data[];
+}
+JC_Persistent_Chunk;
+
+
+// A list of chunk pointers plus the amount of elements within them. Once a version is referenced by a snapshot
+// it is frozen, and the writer moves on to a copy of the chunk list the next time it modifies the vector
+typedef struct JC_Persistent_Version
+{
+	atomic_size_t references;
+	size_t allocated;
+	size_t type_size;
+
+	JC_Vector* chunks;
+}
+JC_Persistent_Version;
+
+
+// lock is only held while the writer modifies the current version and while a snapshot is being taken,
+// so that a snapshot can never see a half finished write
+typedef struct JC_Persistent_Vector
+{
+	JC_Persistent_Version* current;
+	atomic_flag lock;
+}
+JC_Persistent_Vector;
+
+
+
+
+
+
+// ---------------------------------------------------------------------------
+//								Chunks and Versions
+// ---------------------------------------------------------------------------
+
+static inline JC_Persistent_Chunk* JC_persistent_chunk_construct(const size_t type_size)
+{
+	JC_Persistent_Chunk* new_chunk = malloc(sizeof(JC_Persistent_Chunk) + JC_C_PERSISTENT_VECTOR_CHUNK_ELEMENTS * type_size);
+
+	if (new_chunk == NULL)
+		return NULL;
+
+	atomic_init(&new_chunk->references, 1);
+	return new_chunk;
+}
+
+
+static inline void JC_persistent_chunk_release(JC_Persistent_Chunk* const chunk)
+{
+	if (atomic_fetch_sub_explicit(&chunk->references, 1, memory_order_acq_rel) == 1)
+		free(chunk);
+}
+
+
+static inline JC_Persistent_Chunk** JC_persistent_version_chunks(const JC_Persistent_Version* const restrict version)
+{
+	return (JC_Persistent_Chunk**)JC_vector_data(version->chunks);
+}
+
+
+static inline JC_Persistent_Version* JC_persistent_version_construct(const size_t type_size, const size_t chunk_count)
+{
+	JC_Persistent_Version* new_version = malloc(sizeof(JC_Persistent_Version));
+
+	if (new_version == NULL)
+		return NULL;
+
+	new_version->chunks = JC_vector_construct(chunk_count, sizeof(JC_Persistent_Chunk*));
+
+	if (new_version->chunks == NULL)
+	{
+		free(new_version);
+		return NULL;
+	}
+
+	atomic_init(&new_version->references, 1);
+	new_version->allocated = 0;
+	new_version->type_size = type_size;
+
+	return new_version;
+}
+
+
+static inline void JC_persistent_version_release(JC_Persistent_Version* const version)
+{
+	if (atomic_fetch_sub_explicit(&version->references, 1, memory_order_acq_rel) != 1)
+		return;
+
+	JC_Persistent_Chunk** chunks = JC_persistent_version_chunks(version);
+
+	for (size_t i = 0; i < version->chunks->allocated; i++)
+		JC_persistent_chunk_release(chunks[i]);
+
+	JC_vector_destruct(&version->chunks);
+	free(version);
+}
+
+
+// Called with the lock held. If a snapshot shares the current version, the writer switches to a copy of its chunk list.
+// Only the pointers are copied, every chunk just gains a reference
+static inline bool JC_persistent_vector_own_version(JC_Persistent_Vector* const restrict vector)
+{
+	JC_Persistent_Version* old_version = vector->current;
+
+	if (atomic_load_explicit(&old_version->references, memory_order_acquire) == 1)
+		return true;
+
+	JC_Persistent_Version* new_version = JC_persistent_version_construct(old_version->type_size, old_version->chunks->allocated);
+
+	if (new_version == NULL)
+		return false;
+
+	JC_Persistent_Chunk** chunks = JC_persistent_version_chunks(old_version);
+
+	for (size_t i = 0; i < old_version->chunks->allocated; i++)
+	{
+		atomic_fetch_add_explicit(&chunks[i]->references, 1, memory_order_relaxed);
+		JC_vector_pushback_ptr(new_version->chunks, &chunks[i]);
+	}
+
+	new_version->allocated = old_version->allocated;
+	vector->current = new_version;
+
+	JC_persistent_version_release(old_version);
+	return true;
+}
+
+
+// Called with the lock held, after JC_persistent_vector_own_version. Copies the chunk if any snapshot still uses it
+static inline JC_Persistent_Chunk* JC_persistent_vector_own_chunk(JC_Persistent_Vector* const restrict vector, const size_t chunk_index)
+{
+	JC_Persistent_Chunk** chunks = JC_persistent_version_chunks(vector->current);
+	JC_Persistent_Chunk* old_chunk = chunks[chunk_index];
+
+	if (atomic_load_explicit(&old_chunk->references, memory_order_acquire) == 1)
+		return old_chunk;
+
+	JC_Persistent_Chunk* new_chunk = JC_persistent_chunk_construct(vector->current->type_size);
+
+	if (new_chunk == NULL)
+		return NULL;
+
+	memcpy(new_chunk->data, old_chunk->data, JC_C_PERSISTENT_VECTOR_CHUNK_ELEMENTS * vector->current->type_size);
+	chunks[chunk_index] = new_chunk;
+
+	JC_persistent_chunk_release(old_chunk);
+	return new_chunk;
+}
+
+
+static inline void JC_persistent_vector_lock(JC_Persistent_Vector* const restrict vector)
+{
+	while (atomic_flag_test_and_set_explicit(&vector->lock, memory_order_acquire))
+		;
+}
+
+static inline void JC_persistent_vector_unlock(JC_Persistent_Vector* const restrict vector)
+{
+	atomic_flag_clear_explicit(&vector->lock, memory_order_release);
+}
+
+
+
+
+
+
+// ---------------------------------------------------------------------------
+//							Setup and Cleanup
+// ---------------------------------------------------------------------------
+
+static inline JC_Persistent_Vector* JC_persistent_vector_construct(size_t size, size_t type_size)
+{
+	JC_Persistent_Vector* new_vector = malloc(sizeof(JC_Persistent_Vector));
+
+	if (new_vector == NULL)
+	{
+		return NULL;
+	}
+
+	new_vector->current = JC_persistent_version_construct(type_size, size / JC_C_PERSISTENT_VECTOR_CHUNK_ELEMENTS);
+
+	if (new_vector->current == NULL)
+	{
+		free(new_vector);
+		return NULL;
+	}
+
+	atomic_flag_clear(&new_vector->lock);
+
+	return new_vector;
+}
+
+// Snapshots taken from the vector stay valid after it is destructed, and each must still be released
+static inline void JC_persistent_vector_destruct(JC_Persistent_Vector** const restrict vector)
+{
+	if (vector == NULL || *vector == NULL)
+		return;
+
+	JC_persistent_version_release((*vector)->current);
+
+	free(*vector);
+	*vector = NULL;
+}
+
+
+
+
+
+
+// --------------------------------------------------------------------------------
+//									Writer
+// --------------------------------------------------------------------------------
+
+// The writer's functions must all be called from a single thread, or be externally synchronized with each other.
+// They may run at the same time as snapshots are taken, read, and released on other threads
+
+static inline size_t JC_persistent_vector_size(const JC_Persistent_Vector* const restrict vector)
+{
+	return vector->current->allocated;
+}
+
+
+static inline const char* JC_persistent_vector_at_ptr(const JC_Persistent_Vector* const restrict vector, const size_t index)
+{
+	if (index >= vector->current->allocated)
+		return NULL;
+
+	JC_Persistent_Chunk** chunks = JC_persistent_version_chunks(vector->current);
+
+	return chunks[index / JC_C_PERSISTENT_VECTOR_CHUNK_ELEMENTS]->data + (index % JC_C_PERSISTENT_VECTOR_CHUNK_ELEMENTS) * vector->current->type_size;
+}
+
+
+static inline bool JC_persistent_vector_set_ptr(JC_Persistent_Vector* const restrict vector, const size_t index, const void* const restrict value)
+{
+	if (index >= vector->current->allocated)
+		return false;
+
+	JC_persistent_vector_lock(vector);
+
+	JC_Persistent_Chunk* chunk = NULL;
+
+	if (JC_persistent_vector_own_version(vector))
+		chunk = JC_persistent_vector_own_chunk(vector, index / JC_C_PERSISTENT_VECTOR_CHUNK_ELEMENTS);
+
+	if (chunk != NULL)
+		memcpy(chunk->data + (index % JC_C_PERSISTENT_VECTOR_CHUNK_ELEMENTS) * vector->current->type_size, value, vector->current->type_size);
+
+	JC_persistent_vector_unlock(vector);
+
+	return chunk != NULL;
+}
+
+
+static inline bool JC_persistent_vector_pushback_ptr(JC_Persistent_Vector* const restrict vector, const void* const restrict value)
+{
+	JC_persistent_vector_lock(vector);
+
+	if (!JC_persistent_vector_own_version(vector))
+	{
+		JC_persistent_vector_unlock(vector);
+		return false;
+	}
+
+	JC_Persistent_Version* version = vector->current;
+	size_t chunk_index = version->allocated / JC_C_PERSISTENT_VECTOR_CHUNK_ELEMENTS;
+	JC_Persistent_Chunk* chunk;
+
+	if (chunk_index == version->chunks->allocated)
+	{
+		chunk = JC_persistent_chunk_construct(version->type_size);
+
+		if (chunk != NULL && !JC_vector_pushback_ptr(version->chunks, &chunk))
+		{
+			free(chunk);
+			chunk = NULL;
+		}
+	}
+	else
+	{
+		chunk = JC_persistent_vector_own_chunk(vector, chunk_index);
+	}
+
+	if (chunk != NULL)
+	{
+		memcpy(chunk->data + (version->allocated % JC_C_PERSISTENT_VECTOR_CHUNK_ELEMENTS) * version->type_size, value, version->type_size);
+		version->allocated++;
+	}
+
+	JC_persistent_vector_unlock(vector);
+
+	return chunk != NULL;
+}
+
+
+static inline void JC_persistent_vector_pop_back(JC_Persistent_Vector* const restrict vector)
+{
+	if (vector->current->allocated == 0)
+		return;
+
+	JC_persistent_vector_lock(vector);
+
+	if (JC_persistent_vector_own_version(vector))
+	{
+		JC_Persistent_Version* version = vector->current;
+		version->allocated--;
+
+		// a chunk left with no elements is dropped, snapshots which still use it keep it alive
+		if (version->allocated % JC_C_PERSISTENT_VECTOR_CHUNK_ELEMENTS == 0)
+		{
+			JC_persistent_chunk_release(*(JC_Persistent_Chunk**)JC_vector_back(version->chunks));
+			JC_vector_pop_back(version->chunks);
+		}
+	}
+
+	JC_persistent_vector_unlock(vector);
+}
+
+
+
+
+
+
+// --------------------------------------------------------------------------------
+//									Snapshots
+// --------------------------------------------------------------------------------
+
+// O(1). Can be called from any thread. The returned version never changes, and can be read without any locking
+static inline JC_Persistent_Version* JC_persistent_vector_snapshot(JC_Persistent_Vector* const restrict vector)
+{
+	JC_persistent_vector_lock(vector);
+
+	JC_Persistent_Version* version = vector->current;
+	atomic_fetch_add_explicit(&version->references, 1, memory_order_relaxed);
+
+	JC_persistent_vector_unlock(vector);
+
+	return version;
+}
+
+
+static inline void JC_persistent_snapshot_release(JC_Persistent_Version** const restrict snapshot)
+{
+	if (snapshot == NULL || *snapshot == NULL)
+		return;
+
+	JC_persistent_version_release(*snapshot);
+	*snapshot = NULL;
+}
+
+
+static inline size_t JC_persistent_snapshot_size(const JC_Persistent_Version* const restrict snapshot)
+{
+	return snapshot->allocated;
+}
+
+
+static inline const char* JC_persistent_snapshot_at_ptr(const JC_Persistent_Version* const restrict snapshot, const size_t index)
+{
+	if (index >= snapshot->allocated)
+		return NULL;
+
+	JC_Persistent_Chunk** chunks = JC_persistent_version_chunks(snapshot);
+
+	return chunks[index / JC_C_PERSISTENT_VECTOR_CHUNK_ELEMENTS]->data + (index % JC_C_PERSISTENT_VECTOR_CHUNK_ELEMENTS) * snapshot->type_size;
+}
+
+
+static inline size_t JC_persistent_snapshot_chunk_count(const JC_Persistent_Version* const restrict snapshot)
+{
+	return snapshot->chunks->allocated;
+}
+
+
+// Returns the elements of a whole chunk at once for fast iteration, and sets count to how many elements it holds
+static inline const char* JC_persistent_snapshot_chunk(const JC_Persistent_Version* const restrict snapshot, const size_t chunk_index, size_t* const restrict count)
+{
+	if (chunk_index >= snapshot->chunks->allocated)
+	{
+		*count = 0;
+		return NULL;
+	}
+
+	size_t chunk_start = chunk_index * JC_C_PERSISTENT_VECTOR_CHUNK_ELEMENTS;
+	size_t remaining = snapshot->allocated - chunk_start;
+
+	*count = remaining < JC_C_PERSISTENT_VECTOR_CHUNK_ELEMENTS ? remaining : JC_C_PERSISTENT_VECTOR_CHUNK_ELEMENTS;
+
+	return JC_persistent_version_chunks(snapshot)[chunk_index]->data;
+}
+
+
+#endif
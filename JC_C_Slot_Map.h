@@ -0,0 +1,281 @@
+#ifndef JC_C_SLOT_MAP_H_FILE
+#define JC_C_SLOT_MAP_H_FILE
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "JC_C_Vector.h"
+
+// Marks the end of the free slot list
+#define JC_C_SLOT_MAP_NO_SLOT UINT32_MAX
+
+
+
+
+// Refers to one element of a slot map for as long as that element lives. Once the element is erased the slot's generation
+// moves on, so the old handle is rejected even after the slot is reused. Generations start at 1, so a zeroed handle is never valid
+typedef struct JC_Slot_Handle
+{
+	uint32_t index;
+	uint32_t generation;
+}
+JC_Slot_Handle;
+
+
+// While the slot is in use, position is where its element sits within the dense values.
+// While it's free, position is the index of the next free slot instead
+typedef struct JC_Slot_Map_Slot
+{
+	uint32_t position;
+	uint32_t generation;
+}
+JC_Slot_Map_Slot;
+
+
+// values holds every live element packed together, owners holds the slot index of each of those elements,
+// and slots maps a handle's index to where its element currently is
+typedef struct JC_Slot_Map
+{
+	JC_Vector* slots;
+	JC_Vector* values;
+	JC_Vector* owners;
+
+	uint32_t free_head;
+}
+JC_Slot_Map;
+
+
+
+
+
+
+// ---------------------------------------------------------------------------
+//							Setup and Cleanup
+// ---------------------------------------------------------------------------
+
+static inline JC_Slot_Map* JC_slot_map_construct(size_t size, size_t type_size)
+{
+	JC_Slot_Map* new_map = malloc(sizeof(JC_Slot_Map));
+
+	if (new_map == NULL)
+	{
+		return NULL;
+	}
+
+	new_map->slots = JC_vector_construct(size, sizeof(JC_Slot_Map_Slot));
+	new_map->values = JC_vector_construct(size, type_size);
+	new_map->owners = JC_vector_construct(size, sizeof(uint32_t));
+
+	if (new_map->slots == NULL || new_map->values == NULL || new_map->owners == NULL)
+	{
+		JC_vector_destruct(&new_map->slots);
+		JC_vector_destruct(&new_map->values);
+		JC_vector_destruct(&new_map->owners);
+		free(new_map);
+		return NULL;
+	}
+
+	new_map->free_head = JC_C_SLOT_MAP_NO_SLOT;
+
+	return new_map;
+}
+
+static inline void JC_slot_map_destruct(JC_Slot_Map** const restrict map)
+{
+	if (map == NULL || *map == NULL)
+		return;
+
+	JC_vector_destruct(&(*map)->slots);
+	JC_vector_destruct(&(*map)->values);
+	JC_vector_destruct(&(*map)->owners);
+
+	free(*map);
+	*map = NULL;
+}
+
+
+
+
+
+
+// --------------------------------------------------------------------------------
+//									Element Access
+// --------------------------------------------------------------------------------
+
+static inline JC_Slot_Map_Slot* JC_slot_map_slot(const JC_Slot_Map* const restrict map, const size_t index)
+{
+	return (JC_Slot_Map_Slot*)JC_vector_at_ptr_unsafe(map->slots, index);
+}
+
+
+static inline bool JC_slot_map_contains(const JC_Slot_Map* const restrict map, const JC_Slot_Handle handle)
+{
+	if (handle.index >= map->slots->allocated)
+		return false;
+
+	return JC_slot_map_slot(map, handle.index)->generation == handle.generation;
+}
+
+
+// Returns NULL if the handle's element has been erased
+static inline char* JC_slot_map_get(const JC_Slot_Map* const restrict map, const JC_Slot_Handle handle)
+{
+	if (!JC_slot_map_contains(map, handle))
+		return NULL;
+
+	return JC_vector_at_ptr_unsafe(map->values, JC_slot_map_slot(map, handle.index)->position);
+}
+
+
+// Live elements are packed together in no particular order, from index 0 to JC_slot_map_size() - 1
+static inline char* JC_slot_map_data(const JC_Slot_Map* const restrict map)
+{
+	return JC_vector_data(map->values);
+}
+
+
+// The handle of the element at position within JC_slot_map_data()
+static inline JC_Slot_Handle JC_slot_map_handle_at(const JC_Slot_Map* const restrict map, const size_t position)
+{
+	JC_Slot_Handle handle;
+	handle.index = *(uint32_t*)JC_vector_at_ptr_unsafe(map->owners, position);
+	handle.generation = JC_slot_map_slot(map, handle.index)->generation;
+
+	return handle;
+}
+
+
+
+
+
+
+// -----------------------------------------------------------------------------
+//									Capacity
+// -----------------------------------------------------------------------------
+
+static inline bool JC_slot_map_empty(const JC_Slot_Map* const restrict map)
+{
+	return !map->values->allocated;
+}
+
+static inline size_t JC_slot_map_size(const JC_Slot_Map* const restrict map)
+{
+	return map->values->allocated;
+}
+
+
+static inline bool JC_slot_map_reserve(JC_Slot_Map* const restrict map, const size_t size)
+{
+	return JC_vector_reserve(map->slots, size) && JC_vector_reserve(map->values, size) && JC_vector_reserve(map->owners, size);
+}
+
+
+
+
+
+
+// -----------------------------------------------------------------------------
+//									Modifiers
+// -----------------------------------------------------------------------------
+
+// Copies value into the map and writes its handle into handle. Returns a pointer to the stored element,
+// which stays valid until the next insert or erase. Reuses the most recently freed slot if there is one
+static inline char* JC_slot_map_insert_ptr(JC_Slot_Map* const restrict map, const void* const restrict value, JC_Slot_Handle* const restrict handle)
+{
+	uint32_t slot_index = map->free_head;
+
+	if (slot_index == JC_C_SLOT_MAP_NO_SLOT)
+	{
+		if (map->slots->allocated >= JC_C_SLOT_MAP_NO_SLOT)
+			return NULL;
+
+		JC_Slot_Map_Slot new_slot = { 0, 1 };
+
+		if (!JC_vector_pushback_ptr(map->slots, &new_slot))
+			return NULL;
+
+		slot_index = (uint32_t)(map->slots->allocated - 1);
+		JC_slot_map_slot(map, slot_index)->position = JC_C_SLOT_MAP_NO_SLOT;
+	}
+
+	// the new slot is left on the free list until both pushes have succeeded
+	if (!JC_vector_pushback_ptr(map->values, value))
+	{
+		map->free_head = slot_index;
+		return NULL;
+	}
+
+	if (!JC_vector_pushback_ptr(map->owners, &slot_index))
+	{
+		JC_vector_pop_back(map->values);
+		map->free_head = slot_index;
+		return NULL;
+	}
+
+	JC_Slot_Map_Slot* slot = JC_slot_map_slot(map, slot_index);
+	map->free_head = slot->position;
+	slot->position = (uint32_t)(map->values->allocated - 1);
+
+	handle->index = slot_index;
+	handle->generation = slot->generation;
+
+	return JC_vector_back(map->values);
+}
+
+
+// Moves the last element into the erased element's place, so erasing is O(1) but changes the order of the packed elements.
+// Returns false if the handle's element has already been erased
+static inline bool JC_slot_map_erase(JC_Slot_Map* const restrict map, const JC_Slot_Handle handle)
+{
+	if (!JC_slot_map_contains(map, handle))
+		return false;
+
+	JC_Slot_Map_Slot* slot = JC_slot_map_slot(map, handle.index);
+	size_t last = map->values->allocated - 1;
+
+	if (slot->position != last)
+	{
+		uint32_t moved_owner = *(uint32_t*)JC_vector_at_ptr_unsafe(map->owners, last);
+
+		memcpy(JC_vector_at_ptr_unsafe(map->values, slot->position), JC_vector_at_ptr_unsafe(map->values, last), map->values->type_size);
+		*(uint32_t*)JC_vector_at_ptr_unsafe(map->owners, slot->position) = moved_owner;
+		JC_slot_map_slot(map, moved_owner)->position = slot->position;
+	}
+
+	JC_vector_pop_back(map->values);
+	JC_vector_pop_back(map->owners);
+
+	// 0 is skipped when the generation wraps around, so that a zeroed handle stays invalid
+	slot->generation++;
+	if (slot->generation == 0)
+		slot->generation = 1;
+
+	slot->position = map->free_head;
+	map->free_head = handle.index;
+
+	return true;
+}
+
+
+// Erases every element. Every handle given out so far becomes invalid
+static inline void JC_slot_map_clear(JC_Slot_Map* const restrict map)
+{
+	for (size_t i = 0; i < map->values->allocated; i++)
+	{
+		JC_Slot_Handle handle = JC_slot_map_handle_at(map, i);
+		JC_Slot_Map_Slot* slot = JC_slot_map_slot(map, handle.index);
+
+		slot->generation++;
+		if (slot->generation == 0)
+			slot->generation = 1;
+
+		slot->position = map->free_head;
+		map->free_head = handle.index;
+	}
+
+	JC_vector_clear(map->values);
+	JC_vector_clear(map->owners);
+}
+
+
+#endif
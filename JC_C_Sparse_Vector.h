@@ -0,0 +1,478 @@
+#ifndef JC_C_SPARSE_VECTOR_H_FILE
+#define JC_C_SPARSE_VECTOR_H_FILE
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "JC_C_Vector.h"
+#include "JC_C_Bit_Vector.h"
+
+#define JC_C_SPARSE_VECTOR_BLOCK_BITS 8
+#define JC_C_SPARSE_VECTOR_BLOCK_ELEMENTS (1 << JC_C_SPARSE_VECTOR_BLOCK_BITS)
+#define JC_C_SPARSE_VECTOR_BLOCK_WORDS (JC_C_SPARSE_VECTOR_BLOCK_ELEMENTS / JC_C_BIT_VECTOR_WORD_BITS)
+
+// How many words of the block bitmap make up one superblock. Bounds both the popcounts needed to find a block and the pointers
+// moved when a block is added or removed
+#define JC_C_SPARSE_VECTOR_SUPERBLOCK_WORDS 8
+#define JC_C_SPARSE_VECTOR_SUPERBLOCK_BLOCKS (JC_C_SPARSE_VECTOR_SUPERBLOCK_WORDS * JC_C_BIT_VECTOR_WORD_BITS)
+
+
+
+
+// Storage for one run of JC_C_SPARSE_VECTOR_BLOCK_ELEMENTS elements holding at least one non default value. present has a
+// set bit for every element that holds one, and every other element holds a copy of the default value
+typedef struct JC_Sparse_Block
+{
+	uint64_t present[JC_C_SPARSE_VECTOR_BLOCK_WORDS];
+	size_t count;
+
+	_Alignas(max_align_t) char data[];
+}
+JC_Sparse_Block;
+
+
+// populated has one bit per block of the index space, set when that block has storage. Every JC_C_SPARSE_VECTOR_SUPERBLOCK_WORDS
+// words of it make a superblock, and superblocks holds a vector per superblock with the pointers of only its populated blocks,
+// in block order, or NULL if it has none. A block's position in that vector is the amount of set bits before its own within the
+// superblock, so finding a block is O(1), and adding or removing one only touches its own superblock
+typedef struct JC_Sparse_Vector
+{
+	size_t allocated;
+	size_t type_size;
+	size_t non_default;
+	size_t block_count;
+
+	JC_Bit_Vector* populated;
+	JC_Vector* superblocks;
+
+	char* default_value;
+}
+JC_Sparse_Vector;
+
+
+
+
+
+
+// ---------------------------------------------------------------------------
+//							Setup and Cleanup
+// ---------------------------------------------------------------------------
+
+static inline size_t JC_sparse_vector_block_total(const size_t size)
+{
+	return (size + JC_C_SPARSE_VECTOR_BLOCK_ELEMENTS - 1) >> JC_C_SPARSE_VECTOR_BLOCK_BITS;
+}
+
+static inline size_t JC_sparse_vector_superblock_total(const size_t block_total)
+{
+	return (block_total + JC_C_SPARSE_VECTOR_SUPERBLOCK_BLOCKS - 1) / JC_C_SPARSE_VECTOR_SUPERBLOCK_BLOCKS;
+}
+
+
+// Frees every block of every superblock, leaving each superblock NULL
+static inline void JC_sparse_vector_free_blocks(JC_Sparse_Vector* const restrict vector)
+{
+	JC_Vector** superblocks = (JC_Vector**)JC_vector_data(vector->superblocks);
+
+	for (size_t i = 0; i < vector->superblocks->allocated; i++)
+	{
+		if (superblocks[i] == NULL)
+			continue;
+
+		JC_Sparse_Block** blocks = (JC_Sparse_Block**)JC_vector_data(superblocks[i]);
+
+		for (size_t j = 0; j < superblocks[i]->allocated; j++)
+			free(blocks[j]);
+
+		JC_vector_destruct(&superblocks[i]);
+	}
+
+	vector->block_count = 0;
+}
+
+
+// A NULL default_value means zeros
+static inline JC_Sparse_Vector* JC_sparse_vector_construct(size_t size, size_t type_size, const void* const restrict default_value)
+{
+	JC_Sparse_Vector* new_vector = malloc(sizeof(JC_Sparse_Vector));
+
+	if (new_vector == NULL)
+	{
+		return NULL;
+	}
+
+	size_t block_total = JC_sparse_vector_block_total(size);
+	size_t superblock_total = JC_sparse_vector_superblock_total(block_total);
+	JC_Vector* empty = NULL;
+
+	new_vector->allocated = size;
+	new_vector->type_size = type_size;
+	new_vector->non_default = 0;
+	new_vector->block_count = 0;
+	new_vector->populated = JC_bit_vector_construct(block_total);
+	new_vector->superblocks = JC_vector_construct(superblock_total, sizeof(JC_Vector*));
+	new_vector->default_value = calloc(1, type_size ? type_size : 1);
+
+	if (new_vector->populated == NULL || new_vector->superblocks == NULL || new_vector->default_value == NULL
+		|| !JC_bit_vector_resize(new_vector->populated, block_total, false)
+		|| !JC_vector_resize_ptr(new_vector->superblocks, superblock_total, &empty))
+	{
+		JC_bit_vector_destruct(&new_vector->populated);
+		JC_vector_destruct(&new_vector->superblocks);
+		free(new_vector->default_value);
+		free(new_vector);
+		return NULL;
+	}
+
+	if (default_value != NULL)
+		memcpy(new_vector->default_value, default_value, type_size);
+
+	return new_vector;
+}
+
+static inline void JC_sparse_vector_destruct(JC_Sparse_Vector** const restrict vector)
+{
+	if (vector == NULL || *vector == NULL)
+		return;
+
+	JC_sparse_vector_free_blocks(*vector);
+
+	JC_bit_vector_destruct(&(*vector)->populated);
+	JC_vector_destruct(&(*vector)->superblocks);
+	free((*vector)->default_value);
+
+	free(*vector);
+	*vector = NULL;
+}
+
+
+
+
+
+
+// ---------------------------------------------------------------------------
+//								Blocks
+// ---------------------------------------------------------------------------
+
+static inline JC_Vector** JC_sparse_vector_superblock(const JC_Sparse_Vector* const restrict vector, const size_t block_index)
+{
+	return (JC_Vector**)JC_vector_at_ptr_unsafe(vector->superblocks, block_index / JC_C_SPARSE_VECTOR_SUPERBLOCK_BLOCKS);
+}
+
+
+// Where the block sits, or would be inserted, within its superblock's populated blocks. Counted with at most
+// JC_C_SPARSE_VECTOR_SUPERBLOCK_WORDS popcounts, so there is nothing to keep up to date when blocks come and go
+static inline size_t JC_sparse_vector_block_position(const JC_Sparse_Vector* const restrict vector, const size_t block_index)
+{
+	const uint64_t* words = vector->populated->data;
+	size_t word = block_index / JC_C_BIT_VECTOR_WORD_BITS;
+	uint64_t below = ((uint64_t)1 << (block_index % JC_C_BIT_VECTOR_WORD_BITS)) - 1;
+	size_t position = JC_bit_vector_popcount_word(words[word] & below);
+
+	for (size_t previous = word - word % JC_C_SPARSE_VECTOR_SUPERBLOCK_WORDS; previous < word; previous++)
+		position += JC_bit_vector_popcount_word(words[previous]);
+
+	return position;
+}
+
+
+static inline JC_Sparse_Block* JC_sparse_vector_block(const JC_Sparse_Vector* const restrict vector, const size_t block_index)
+{
+	if (!JC_bit_vector_get(vector->populated, block_index))
+		return NULL;
+
+	JC_Vector* superblock = *JC_sparse_vector_superblock(vector, block_index);
+
+	return *(JC_Sparse_Block**)JC_vector_at_ptr_unsafe(superblock, JC_sparse_vector_block_position(vector, block_index));
+}
+
+
+static inline JC_Sparse_Block* JC_sparse_vector_add_block(JC_Sparse_Vector* const restrict vector, const size_t block_index)
+{
+	JC_Sparse_Block* block = malloc(sizeof(JC_Sparse_Block) + JC_C_SPARSE_VECTOR_BLOCK_ELEMENTS * vector->type_size);
+
+	if (block == NULL)
+		return NULL;
+
+	memset(block->present, 0, sizeof(block->present));
+	block->count = 0;
+
+	for (size_t i = 0; i < JC_C_SPARSE_VECTOR_BLOCK_ELEMENTS; i++)
+		memcpy(block->data + i * vector->type_size, vector->default_value, vector->type_size);
+
+	JC_Vector** superblock = JC_sparse_vector_superblock(vector, block_index);
+
+	if (*superblock == NULL)
+		*superblock = JC_vector_construct(0, sizeof(JC_Sparse_Block*));
+
+	if (*superblock == NULL || JC_vector_insert_ptr(*superblock, JC_sparse_vector_block_position(vector, block_index), &block) == NULL)
+	{
+		if (*superblock != NULL && (*superblock)->allocated == 0)
+			JC_vector_destruct(superblock);
+
+		free(block);
+		return NULL;
+	}
+
+	JC_bit_vector_set(vector->populated, block_index, true);
+	vector->block_count++;
+
+	return block;
+}
+
+
+static inline void JC_sparse_vector_remove_block(JC_Sparse_Vector* const restrict vector, const size_t block_index)
+{
+	size_t position = JC_sparse_vector_block_position(vector, block_index);
+	JC_Vector** superblock = JC_sparse_vector_superblock(vector, block_index);
+
+	free(*(JC_Sparse_Block**)JC_vector_at_ptr_unsafe(*superblock, position));
+	JC_vector_erase(*superblock, position);
+
+	// an empty superblock gives its storage back
+	if ((*superblock)->allocated == 0)
+		JC_vector_destruct(superblock);
+
+	JC_bit_vector_set(vector->populated, block_index, false);
+	vector->block_count--;
+}
+
+
+// Puts the default value back into one element of a block, and frees the block once nothing in it is left
+static inline void JC_sparse_vector_reset_element(JC_Sparse_Vector* const restrict vector, JC_Sparse_Block* const block, const size_t block_index, const size_t offset)
+{
+	block->present[offset / JC_C_BIT_VECTOR_WORD_BITS] &= ~((uint64_t)1 << (offset % JC_C_BIT_VECTOR_WORD_BITS));
+	memcpy(block->data + offset * vector->type_size, vector->default_value, vector->type_size);
+
+	block->count--;
+	vector->non_default--;
+
+	if (block->count == 0)
+		JC_sparse_vector_remove_block(vector, block_index);
+}
+
+
+
+
+
+
+// --------------------------------------------------------------------------------
+//									Element Access
+// --------------------------------------------------------------------------------
+
+// Returns a pointer to the element, or to the default value if the element has never been set. The pointer is only valid
+// until the next change to the vector, and mustn't be written through since it may point at the shared default value.
+// Returns NULL if index is out of bounds
+static inline const char* JC_sparse_vector_get(const JC_Sparse_Vector* const restrict vector, const size_t index)
+{
+	if (index >= vector->allocated)
+		return NULL;
+
+	JC_Sparse_Block* block = JC_sparse_vector_block(vector, index >> JC_C_SPARSE_VECTOR_BLOCK_BITS);
+
+	if (block == NULL)
+		return vector->default_value;
+
+	return block->data + (index & (JC_C_SPARSE_VECTOR_BLOCK_ELEMENTS - 1)) * vector->type_size;
+}
+
+
+static inline bool JC_sparse_vector_is_default(const JC_Sparse_Vector* const restrict vector, const size_t index)
+{
+	if (index >= vector->allocated)
+		return true;
+
+	JC_Sparse_Block* block = JC_sparse_vector_block(vector, index >> JC_C_SPARSE_VECTOR_BLOCK_BITS);
+	size_t offset = index & (JC_C_SPARSE_VECTOR_BLOCK_ELEMENTS - 1);
+
+	return block == NULL || !((block->present[offset / JC_C_BIT_VECTOR_WORD_BITS] >> (offset % JC_C_BIT_VECTOR_WORD_BITS)) & 1);
+}
+
+
+// Setting an element to the default value frees its storage, and frees its block once the whole block is back to default.
+// Returns false if index is out of bounds, or a new block couldn't be allocated
+static inline bool JC_sparse_vector_set(JC_Sparse_Vector* const restrict vector, const size_t index, const void* const restrict value)
+{
+	if (index >= vector->allocated)
+		return false;
+
+	size_t block_index = index >> JC_C_SPARSE_VECTOR_BLOCK_BITS;
+	size_t offset = index & (JC_C_SPARSE_VECTOR_BLOCK_ELEMENTS - 1);
+	uint64_t mask = (uint64_t)1 << (offset % JC_C_BIT_VECTOR_WORD_BITS);
+	JC_Sparse_Block* block = JC_sparse_vector_block(vector, block_index);
+
+	if (memcmp(value, vector->default_value, vector->type_size) == 0)
+	{
+		if (block != NULL && (block->present[offset / JC_C_BIT_VECTOR_WORD_BITS] & mask))
+			JC_sparse_vector_reset_element(vector, block, block_index, offset);
+
+		return true;
+	}
+
+	if (block == NULL)
+	{
+		block = JC_sparse_vector_add_block(vector, block_index);
+
+		if (block == NULL)
+			return false;
+	}
+
+	if (!(block->present[offset / JC_C_BIT_VECTOR_WORD_BITS] & mask))
+	{
+		block->present[offset / JC_C_BIT_VECTOR_WORD_BITS] |= mask;
+		block->count++;
+		vector->non_default++;
+	}
+
+	memcpy(block->data + offset * vector->type_size, value, vector->type_size);
+
+	return true;
+}
+
+
+static inline bool JC_sparse_vector_reset(JC_Sparse_Vector* const restrict vector, const size_t index)
+{
+	return JC_sparse_vector_set(vector, index, vector->default_value);
+}
+
+
+static inline const char* JC_sparse_vector_default(const JC_Sparse_Vector* const restrict vector)
+{
+	return vector->default_value;
+}
+
+
+
+
+
+
+// --------------------------------------------------------------------------------
+//									Iterators
+// --------------------------------------------------------------------------------
+
+// Returns the index of the first non default element at or after index, or JC_sparse_vector_size() if there is none.
+// Blocks without storage are skipped a whole word of the block bitmap at a time, so only populated blocks are visited
+static inline size_t JC_sparse_vector_next(const JC_Sparse_Vector* const restrict vector, const size_t index)
+{
+	if (index >= vector->allocated)
+		return vector->allocated;
+
+	size_t block_index = JC_bit_vector_find_next_set(vector->populated, index >> JC_C_SPARSE_VECTOR_BLOCK_BITS);
+	size_t offset = block_index == index >> JC_C_SPARSE_VECTOR_BLOCK_BITS ? index & (JC_C_SPARSE_VECTOR_BLOCK_ELEMENTS - 1) : 0;
+
+	while (block_index < vector->populated->allocated)
+	{
+		JC_Sparse_Block* block = JC_sparse_vector_block(vector, block_index);
+
+		for (size_t word = offset / JC_C_BIT_VECTOR_WORD_BITS; word < JC_C_SPARSE_VECTOR_BLOCK_WORDS; word++)
+		{
+			uint64_t bits = block->present[word];
+
+			if (word == offset / JC_C_BIT_VECTOR_WORD_BITS)
+				bits &= UINT64_MAX << (offset % JC_C_BIT_VECTOR_WORD_BITS);
+
+			if (bits != 0)
+				return (block_index << JC_C_SPARSE_VECTOR_BLOCK_BITS) + word * JC_C_BIT_VECTOR_WORD_BITS + JC_bit_vector_count_trailing_zeros(bits);
+		}
+
+		block_index = JC_bit_vector_find_next_set(vector->populated, block_index + 1);
+		offset = 0;
+	}
+
+	return vector->allocated;
+}
+
+
+static inline size_t JC_sparse_vector_first(const JC_Sparse_Vector* const restrict vector)
+{
+	return JC_sparse_vector_next(vector, 0);
+}
+
+
+
+
+
+
+// -----------------------------------------------------------------------------
+//									Capacity
+// -----------------------------------------------------------------------------
+
+static inline size_t JC_sparse_vector_size(const JC_Sparse_Vector* const restrict vector)
+{
+	return vector->allocated;
+}
+
+// The amount of elements which don't hold the default value
+static inline size_t JC_sparse_vector_non_default_count(const JC_Sparse_Vector* const restrict vector)
+{
+	return vector->non_default;
+}
+
+static inline size_t JC_sparse_vector_block_count(const JC_Sparse_Vector* const restrict vector)
+{
+	return vector->block_count;
+}
+
+
+// Bytes used by the blocks that have storage, not counting the block bitmap and the superblock lists
+static inline size_t JC_sparse_vector_block_bytes(const JC_Sparse_Vector* const restrict vector)
+{
+	return vector->block_count * (sizeof(JC_Sparse_Block) + JC_C_SPARSE_VECTOR_BLOCK_ELEMENTS * vector->type_size);
+}
+
+
+
+
+
+
+// -----------------------------------------------------------------------------
+//									Modifiers
+// -----------------------------------------------------------------------------
+
+// Growing only extends the block bitmap, so new elements hold the default value without anything being written.
+// Shrinking frees the blocks past the new end and resets the elements past it in the last block
+static inline bool JC_sparse_vector_resize(JC_Sparse_Vector* const restrict vector, const size_t new_size)
+{
+	size_t block_total = JC_sparse_vector_block_total(new_size);
+	size_t superblock_total = JC_sparse_vector_superblock_total(block_total);
+	JC_Vector* empty = NULL;
+
+	if (new_size < vector->allocated)
+	{
+		for (size_t index = JC_sparse_vector_next(vector, new_size); index < vector->allocated; index = JC_sparse_vector_next(vector, index + 1))
+		{
+			size_t block_index = index >> JC_C_SPARSE_VECTOR_BLOCK_BITS;
+			JC_sparse_vector_reset_element(vector, JC_sparse_vector_block(vector, block_index), block_index, index & (JC_C_SPARSE_VECTOR_BLOCK_ELEMENTS - 1));
+		}
+
+		// shrinking can't fail, and the superblocks past the new end were freed along with their last block
+		JC_bit_vector_resize(vector->populated, block_total, false);
+		JC_vector_resize_ptr(vector->superblocks, superblock_total, &empty);
+		vector->allocated = new_size;
+
+		return true;
+	}
+
+	if (!JC_bit_vector_resize(vector->populated, block_total, false) || !JC_vector_resize_ptr(vector->superblocks, superblock_total, &empty))
+	{
+		JC_bit_vector_resize(vector->populated, JC_sparse_vector_block_total(vector->allocated), false);
+		return false;
+	}
+
+	vector->allocated = new_size;
+	return true;
+}
+
+
+// Resets every element to the default value, keeping the size
+static inline void JC_sparse_vector_clear(JC_Sparse_Vector* const restrict vector)
+{
+	JC_sparse_vector_free_blocks(vector);
+
+	memset(vector->populated->data, 0, JC_C_BIT_VECTOR_WORDS(vector->populated->allocated) * sizeof(uint64_t));
+	vector->non_default = 0;
+}
+
+
+#endif
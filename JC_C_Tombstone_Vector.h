@@ -0,0 +1,259 @@
+#ifndef JC_C_TOMBSTONE_VECTOR_H_FILE
+#define JC_C_TOMBSTONE_VECTOR_H_FILE
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include "JC_C_Vector.h"
+#include "JC_C_Bit_Vector.h"
+
+// Compact once at least this fraction of the slots hold erased elements
+#define JC_C_TOMBSTONE_VECTOR_DEFAULT_RATIO 0.25
+
+
+
+
+// A JC_Vector whose erase only marks the slot as dead instead of moving the elements after it. Dead slots keep their
+// index until the next compaction, which closes every gap in one pass. live has a set bit for every slot that still
+// holds an element, so walking the live elements is a search for set bits and skips whole words of dead slots at once
+typedef struct JC_Tombstone_Vector
+{
+	JC_Vector* vector;
+	JC_Bit_Vector* live;
+
+	size_t dead;
+	double compact_ratio;
+}
+JC_Tombstone_Vector;
+
+
+
+
+
+
+// ---------------------------------------------------------------------------
+//							Setup and Cleanup
+// ---------------------------------------------------------------------------
+
+static inline JC_Tombstone_Vector* JC_tombstone_vector_construct(size_t size, size_t type_size)
+{
+	JC_Tombstone_Vector* new_vector = malloc(sizeof(JC_Tombstone_Vector));
+
+	if (new_vector == NULL)
+	{
+		return NULL;
+	}
+
+	new_vector->vector = JC_vector_construct(size, type_size);
+	new_vector->live = JC_bit_vector_construct(size);
+
+	if (new_vector->vector == NULL || new_vector->live == NULL)
+	{
+		JC_vector_destruct(&new_vector->vector);
+		JC_bit_vector_destruct(&new_vector->live);
+		free(new_vector);
+		return NULL;
+	}
+
+	new_vector->dead = 0;
+	new_vector->compact_ratio = JC_C_TOMBSTONE_VECTOR_DEFAULT_RATIO;
+
+	return new_vector;
+}
+
+static inline void JC_tombstone_vector_destruct(JC_Tombstone_Vector** const restrict vector)
+{
+	if (vector == NULL || *vector == NULL)
+		return;
+
+	JC_vector_destruct(&(*vector)->vector);
+	JC_bit_vector_destruct(&(*vector)->live);
+
+	free(*vector);
+	*vector = NULL;
+}
+
+
+// 0 turns off automatic compaction, leaving it all to JC_tombstone_vector_compact()
+static inline void JC_tombstone_vector_set_compact_ratio(JC_Tombstone_Vector* const restrict vector, const double ratio)
+{
+	vector->compact_ratio = ratio;
+}
+
+
+
+
+
+
+// --------------------------------------------------------------------------------
+//									Element Access
+// --------------------------------------------------------------------------------
+
+static inline bool JC_tombstone_vector_is_live(const JC_Tombstone_Vector* const restrict vector, const size_t index)
+{
+	return JC_bit_vector_get(vector->live, index);
+}
+
+
+// Returns NULL if index is out of bounds or its element has been erased
+static inline char* JC_tombstone_vector_at_ptr(const JC_Tombstone_Vector* const restrict vector, const size_t index)
+{
+	if (!JC_bit_vector_get(vector->live, index))
+		return NULL;
+
+	return JC_vector_at_ptr_unsafe(vector->vector, index);
+}
+
+
+
+
+
+
+// --------------------------------------------------------------------------------
+//									Iterators
+// --------------------------------------------------------------------------------
+
+// Returns the first live slot at or after index, or JC_tombstone_vector_slots() if there is none.
+// for (i = JC_tombstone_vector_first_live(v); i < JC_tombstone_vector_slots(v); i = JC_tombstone_vector_next_live(v, i + 1))
+// visits every live element, and elements may be erased during the loop
+static inline size_t JC_tombstone_vector_next_live(const JC_Tombstone_Vector* const restrict vector, const size_t index)
+{
+	return JC_bit_vector_find_next_set(vector->live, index);
+}
+
+static inline size_t JC_tombstone_vector_first_live(const JC_Tombstone_Vector* const restrict vector)
+{
+	return JC_bit_vector_find_next_set(vector->live, 0);
+}
+
+
+
+
+
+
+// -----------------------------------------------------------------------------
+//									Capacity
+// -----------------------------------------------------------------------------
+
+static inline bool JC_tombstone_vector_empty(const JC_Tombstone_Vector* const restrict vector)
+{
+	return vector->vector->allocated == vector->dead;
+}
+
+// The amount of live elements
+static inline size_t JC_tombstone_vector_size(const JC_Tombstone_Vector* const restrict vector)
+{
+	return vector->vector->allocated - vector->dead;
+}
+
+// The amount of slots, live or dead. Every valid index is below this
+static inline size_t JC_tombstone_vector_slots(const JC_Tombstone_Vector* const restrict vector)
+{
+	return vector->vector->allocated;
+}
+
+static inline size_t JC_tombstone_vector_dead(const JC_Tombstone_Vector* const restrict vector)
+{
+	return vector->dead;
+}
+
+
+static inline bool JC_tombstone_vector_needs_compaction(const JC_Tombstone_Vector* const restrict vector)
+{
+	return vector->compact_ratio > 0 && vector->dead > 0 && vector->dead >= vector->compact_ratio * vector->vector->allocated;
+}
+
+
+
+
+
+
+// -----------------------------------------------------------------------------
+//									Modifiers
+// -----------------------------------------------------------------------------
+
+// Closes every gap left by erased elements in a single pass, moving each run of live elements down with one memmove.
+// Live elements keep their order, but their indices change. Returns the amount of dead slots removed
+static inline size_t JC_tombstone_vector_compact(JC_Tombstone_Vector* const restrict vector)
+{
+	size_t removed = vector->dead;
+
+	if (removed == 0)
+		return 0;
+
+	size_t slots = vector->vector->allocated;
+	size_t type_size = vector->vector->type_size;
+	size_t write = 0;
+	size_t run_start = JC_bit_vector_find_next_set(vector->live, 0);
+
+	while (run_start < slots)
+	{
+		size_t run_end = JC_bit_vector_find_next_clear(vector->live, run_start);
+
+		if (run_start != write)
+			memmove(vector->vector->data + write * type_size, vector->vector->data + run_start * type_size, (run_end - run_start) * type_size);
+
+		write += run_end - run_start;
+		run_start = JC_bit_vector_find_next_set(vector->live, run_end);
+	}
+
+	// every slot left is live, and shrinking a bit vector never fails
+	vector->vector->allocated = write;
+	JC_bit_vector_clear(vector->live);
+	JC_bit_vector_resize(vector->live, write, true);
+	vector->dead = 0;
+
+	return removed;
+}
+
+
+// Only compacts if the dead ratio has been reached. Meant to be called once a batch of erases is done
+static inline size_t JC_tombstone_vector_maybe_compact(JC_Tombstone_Vector* const restrict vector)
+{
+	if (!JC_tombstone_vector_needs_compaction(vector))
+		return 0;
+
+	return JC_tombstone_vector_compact(vector);
+}
+
+
+// Marks the element as erased without moving anything, so every other index stays the same.
+// Returns false if index is out of bounds or its element has already been erased
+static inline bool JC_tombstone_vector_erase(JC_Tombstone_Vector* const restrict vector, const size_t index)
+{
+	if (!JC_bit_vector_get(vector->live, index))
+		return false;
+
+	JC_bit_vector_set(vector->live, index, false);
+	vector->dead++;
+
+	return true;
+}
+
+
+// Compacts first if the dead ratio has been reached, so the space of erased elements is reused before the vector grows
+static inline bool JC_tombstone_vector_pushback_ptr(JC_Tombstone_Vector* const restrict vector, const void* const restrict data)
+{
+	JC_tombstone_vector_maybe_compact(vector);
+
+	if (!JC_vector_pushback_ptr(vector->vector, data))
+		return false;
+
+	if (!JC_bit_vector_pushback(vector->live, true))
+	{
+		JC_vector_pop_back(vector->vector);
+		return false;
+	}
+
+	return true;
+}
+
+
+static inline void JC_tombstone_vector_clear(JC_Tombstone_Vector* const restrict vector)
+{
+	JC_vector_clear(vector->vector);
+	JC_bit_vector_clear(vector->live);
+	vector->dead = 0;
+}
+
+
+#endif
@@ -2,16 +2,64 @@
 #define JC_C_VECTOR_H_FILE
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <threads.h>
 //#include <stdarg.h> not needed now, will be in the future
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
 #define JC_C_VECTOR_RESIZE_FACTOR 2
-#define JC_C_VECTOR_GROW_VECTOR(vector) JC_vector_reserve(vector, vector->capacity * JC_C_VECTOR_RESIZE_FACTOR)
+// A vector whose buffer was released has no capacity left to multiply, so it starts over from JC_C_VECTOR_MIN_ELEMENTS
+#define JC_C_VECTOR_GROW_VECTOR(vector) JC_vector_reserve(vector, (vector)->capacity ? (vector)->capacity * JC_C_VECTOR_RESIZE_FACTOR : JC_C_VECTOR_MIN_ELEMENTS)
 #define JC_C_VECTOR_GROW_FAILURE false
 
 #define JC_C_VECTOR_MIN_ELEMENTS 20
 #define JC_C_VECTOR_MAX_SIZE 1000000 // Arbitrarily set. No particular reason for this size, so feel free to change it
 
+// How many elements ahead the batch access functions prefetch. Should cover roughly one memory latency worth of work
+#define JC_C_VECTOR_PREFETCH_DISTANCE 16
+
+#if defined(__GNUC__) || defined(__clang__)
+#define JC_C_VECTOR_PREFETCH(address, for_write) __builtin_prefetch((address), (for_write))
+#else
+#define JC_C_VECTOR_PREFETCH(address, for_write) ((void)(address))
+#endif
+
+#if defined(_MSC_VER)
+#define JC_C_VECTOR_THREAD_LOCAL __declspec(thread)
+#else
+#define JC_C_VECTOR_THREAD_LOCAL _Thread_local
+#endif
+
+// Buffer pool size classes are powers of 2, from 32 bytes up to the first power of 2 at or above JC_C_VECTOR_MAX_SIZE
+#define JC_C_VECTOR_POOL_MIN_CLASS_BITS 5
+#define JC_C_VECTOR_POOL_CLASSES 16
+#define JC_C_VECTOR_POOL_CLASS_SIZE(size_class) ((size_t)1 << ((size_class) + JC_C_VECTOR_POOL_MIN_CLASS_BITS))
+#define JC_C_VECTOR_POOL_THREAD_CACHE_MAX 16
+#define JC_C_VECTOR_POOL_DEFAULT_THREAD_LIMIT 8
+#define JC_C_VECTOR_POOL_DEFAULT_SHARED_LIMIT 64
 
+#define JC_C_VECTOR_MEMORY_MAX_RECLAIMERS 8
+
+
+
+
+// Element copies specialized for one element size. type_size is only used by the generic versions, the specialized ones
+// copy a fixed amount of bytes which the compiler turns into plain loads and stores instead of a call into memcpy
+typedef struct JC_Vector_Ops
+{
+	// copies one element
+	void (*copy)(char* const restrict destination, const void* const restrict source, const size_t type_size);
+	// copies value into count elements in a row
+	void (*fill)(char* const restrict destination, const void* const restrict value, const size_t count, const size_t type_size);
+	// moves count elements, which may overlap
+	void (*shift)(char* const destination, const char* const source, const size_t count, const size_t type_size);
+}
+JC_Vector_Ops;
 
 
 typedef struct JC_Vector
@@ -22,7 +70,15 @@ typedef struct JC_Vector
 
 	char* data;
 
+	// picked by JC_vector_construct() from type_size
+	const JC_Vector_Ops* ops;
 
+	// links to the other tracked vectors, or NULL if this vector isn't tracked
+	struct JC_Vector* registry_previous;
+	struct JC_Vector* registry_next;
+
+	// what JC_vector_buffer_alloc() gave for this header, so it goes back into the size class it came from
+	size_t header_bytes;
 }
 JC_Vector;
 
@@ -31,51 +87,598 @@ JC_Vector;
 
 
 
+// ---------------------------------------------------------------------------
+//								Element Operations
+// ---------------------------------------------------------------------------
+
+#define JC_C_VECTOR_DEFINE_SIZED_OPS(bytes)																				\
+static void JC_vector_copy_##bytes(char* const restrict destination, const void* const restrict source, const size_t type_size)	\
+{																														\
+	(void)type_size;																									\
+	memcpy(destination, source, bytes);																					\
+}																														\
+																														\
+static void JC_vector_fill_##bytes(char* const restrict destination, const void* const restrict value, const size_t count,	\
+	const size_t type_size)																								\
+{																														\
+	(void)type_size;																									\
+	char element[bytes];																								\
+	memcpy(element, value, bytes);																						\
+																														\
+	for (size_t i = 0; i < count; i++)																					\
+		memcpy(destination + i * bytes, element, bytes);																\
+}																														\
+																														\
+static void JC_vector_shift_##bytes(char* const destination, const char* const source, const size_t count, const size_t type_size)	\
+{																														\
+	(void)type_size;																									\
+	memmove(destination, source, count * bytes);																		\
+}																														\
+																														\
+static const JC_Vector_Ops JC_vector_ops_##bytes = { JC_vector_copy_##bytes, JC_vector_fill_##bytes, JC_vector_shift_##bytes };
+
+JC_C_VECTOR_DEFINE_SIZED_OPS(1)
+JC_C_VECTOR_DEFINE_SIZED_OPS(2)
+JC_C_VECTOR_DEFINE_SIZED_OPS(4)
+JC_C_VECTOR_DEFINE_SIZED_OPS(8)
+JC_C_VECTOR_DEFINE_SIZED_OPS(16)
+JC_C_VECTOR_DEFINE_SIZED_OPS(32)
+
+
+static void JC_vector_copy_generic(char* const restrict destination, const void* const restrict source, const size_t type_size)
+{
+	memcpy(destination, source, type_size);
+}
+
+static void JC_vector_fill_generic(char* const restrict destination, const void* const restrict value, const size_t count, const size_t type_size)
+{
+	for (size_t i = 0; i < count; i++)
+		memcpy(destination + i * type_size, value, type_size);
+}
+
+static void JC_vector_shift_generic(char* const destination, const char* const source, const size_t count, const size_t type_size)
+{
+	memmove(destination, source, count * type_size);
+}
+
+static const JC_Vector_Ops JC_vector_ops_generic = { JC_vector_copy_generic, JC_vector_fill_generic, JC_vector_shift_generic };
+
+
+static inline const JC_Vector_Ops* JC_vector_ops_for_size(const size_t type_size)
+{
+	switch (type_size)
+	{
+	case 1:
+		return &JC_vector_ops_1;
+	case 2:
+		return &JC_vector_ops_2;
+	case 4:
+		return &JC_vector_ops_4;
+	case 8:
+		return &JC_vector_ops_8;
+	case 16:
+		return &JC_vector_ops_16;
+	case 32:
+		return &JC_vector_ops_32;
+	default:
+		return &JC_vector_ops_generic;
+	}
+}
+
+
+
+
+
+
+// ---------------------------------------------------------------------------
+//								Buffer Pool
+// ---------------------------------------------------------------------------
+
+// Recycled buffers are kept per size class, first in a small cache for the calling thread, and once that is full in a
+// list shared by every thread. Buffers in the shared list store the pointer to the next buffer in their first bytes.
+// The pool state is static, so it is shared by everything compiled in the same translation unit as this header.
+// A thread's cache is handed to the shared list when the thread exits, through a tss destructor set up on first use
+typedef struct JC_Vector_Pool_Thread_Cache
+{
+	size_t count[JC_C_VECTOR_POOL_CLASSES];
+	void* buffers[JC_C_VECTOR_POOL_CLASSES][JC_C_VECTOR_POOL_THREAD_CACHE_MAX];
+
+	bool registered;
+}
+JC_Vector_Pool_Thread_Cache;
+
+typedef struct JC_Vector_Pool_Shared
+{
+	atomic_flag lock;
+	size_t count[JC_C_VECTOR_POOL_CLASSES];
+	void* head[JC_C_VECTOR_POOL_CLASSES];
+}
+JC_Vector_Pool_Shared;
+
+
+static bool JC_vector_pool_enabled = false;
+static size_t JC_vector_pool_thread_limit = JC_C_VECTOR_POOL_DEFAULT_THREAD_LIMIT;
+static size_t JC_vector_pool_shared_limit = JC_C_VECTOR_POOL_DEFAULT_SHARED_LIMIT;
+
+static JC_C_VECTOR_THREAD_LOCAL JC_Vector_Pool_Thread_Cache JC_vector_pool_thread_cache;
+static JC_Vector_Pool_Shared JC_vector_pool_shared = { ATOMIC_FLAG_INIT, { 0 }, { NULL } };
+
+static once_flag JC_vector_pool_key_once = ONCE_FLAG_INIT;
+static tss_t JC_vector_pool_key;
+static bool JC_vector_pool_key_created = false;
+
+
+static inline void JC_vector_pool_enable(const bool enable)
+{
+	JC_vector_pool_enabled = enable;
+}
+
+
+static inline void JC_vector_pool_set_limits(size_t thread_limit, const size_t shared_limit)
+{
+	if (thread_limit > JC_C_VECTOR_POOL_THREAD_CACHE_MAX)
+		thread_limit = JC_C_VECTOR_POOL_THREAD_CACHE_MAX;
+
+	JC_vector_pool_thread_limit = thread_limit;
+	JC_vector_pool_shared_limit = shared_limit;
+}
+
+
+static inline void JC_vector_pool_lock(void)
+{
+	while (atomic_flag_test_and_set_explicit(&JC_vector_pool_shared.lock, memory_order_acquire))
+		;
+}
+
+static inline void JC_vector_pool_unlock(void)
+{
+	atomic_flag_clear_explicit(&JC_vector_pool_shared.lock, memory_order_release);
+}
+
+
+// Rounds up when allocating so the buffer fits the request, and down when recycling so the buffer is known
+// to be at least as big as its class. Returns JC_C_VECTOR_POOL_CLASSES for sizes the pool doesn't handle
+static inline size_t JC_vector_pool_size_class(const size_t bytes, const bool round_up)
+{
+	if (bytes < JC_C_VECTOR_POOL_CLASS_SIZE(0))
+		return round_up ? 0 : JC_C_VECTOR_POOL_CLASSES;
+
+	size_t size_class = 0;
+
+	while (size_class < JC_C_VECTOR_POOL_CLASSES && JC_C_VECTOR_POOL_CLASS_SIZE(size_class) < bytes)
+		size_class++;
+
+	if (!round_up && size_class < JC_C_VECTOR_POOL_CLASSES && JC_C_VECTOR_POOL_CLASS_SIZE(size_class) != bytes)
+		size_class--;
+
+	if (!round_up && size_class == JC_C_VECTOR_POOL_CLASSES)
+		size_class--;
+
+	return size_class;
+}
+
+
+// Moves every buffer in cache to the shared list, freeing the ones that don't fit under the shared limit
+static inline void JC_vector_pool_flush_cache(JC_Vector_Pool_Thread_Cache* const cache)
+{
+	JC_vector_pool_lock();
+	for (size_t size_class = 0; size_class < JC_C_VECTOR_POOL_CLASSES; size_class++)
+	{
+		while (cache->count[size_class] > 0)
+		{
+			cache->count[size_class]--;
+			void* buffer = cache->buffers[size_class][cache->count[size_class]];
+
+			if (JC_vector_pool_shared.count[size_class] < JC_vector_pool_shared_limit)
+			{
+				*(void**)buffer = JC_vector_pool_shared.head[size_class];
+				JC_vector_pool_shared.head[size_class] = buffer;
+				JC_vector_pool_shared.count[size_class]++;
+			}
+			else
+			{
+				free(buffer);
+			}
+		}
+	}
+	JC_vector_pool_unlock();
+}
+
+
+// Hands the calling thread's cached buffers to the shared list. Happens on its own when a thread exits, and can be
+// called earlier by a thread that is done with vectors for a while
+static inline void JC_vector_pool_flush_thread(void)
+{
+	JC_vector_pool_flush_cache(&JC_vector_pool_thread_cache);
+}
+
+
+static inline void JC_vector_pool_thread_exit(void* const cache)
+{
+	JC_vector_pool_flush_cache(cache);
+}
+
+static inline void JC_vector_pool_create_key(void)
+{
+	JC_vector_pool_key_created = tss_create(&JC_vector_pool_key, JC_vector_pool_thread_exit) == thrd_success;
+}
+
+
+// Pointing the key at the thread's cache is what makes the destructor run when the thread exits
+static inline void JC_vector_pool_register_thread(JC_Vector_Pool_Thread_Cache* const cache)
+{
+	call_once(&JC_vector_pool_key_once, JC_vector_pool_create_key);
+
+	if (JC_vector_pool_key_created)
+		tss_set(JC_vector_pool_key, cache);
+
+	cache->registered = true;
+}
+
+
+// usable is set to how many bytes the returned buffer can actually hold, which is the whole size class when pooled
+static inline void* JC_vector_buffer_alloc(const size_t bytes, size_t* const restrict usable)
+{
+	size_t size_class = JC_vector_pool_size_class(bytes, true);
+
+	if (!JC_vector_pool_enabled || size_class == JC_C_VECTOR_POOL_CLASSES)
+	{
+		*usable = bytes;
+		return malloc(bytes);
+	}
+
+	size_t class_size = JC_C_VECTOR_POOL_CLASS_SIZE(size_class);
+	*usable = class_size < JC_C_VECTOR_MAX_SIZE ? class_size : JC_C_VECTOR_MAX_SIZE;
+
+	JC_Vector_Pool_Thread_Cache* cache = &JC_vector_pool_thread_cache;
+
+	if (cache->count[size_class] > 0)
+	{
+		cache->count[size_class]--;
+		return cache->buffers[size_class][cache->count[size_class]];
+	}
+
+	void* buffer = NULL;
+
+	JC_vector_pool_lock();
+	if (JC_vector_pool_shared.head[size_class] != NULL)
+	{
+		buffer = JC_vector_pool_shared.head[size_class];
+		JC_vector_pool_shared.head[size_class] = *(void**)buffer;
+		JC_vector_pool_shared.count[size_class]--;
+	}
+	JC_vector_pool_unlock();
+
+	if (buffer == NULL)
+		buffer = malloc(class_size);
+
+	return buffer;
+}
+
+
+// bytes only needs to be a size the buffer is known to hold, such as capacity * type_size, not its exact size
+static inline void JC_vector_buffer_free(void* const buffer, const size_t bytes)
+{
+	size_t size_class = JC_vector_pool_size_class(bytes, false);
+
+	if (buffer == NULL || !JC_vector_pool_enabled || size_class == JC_C_VECTOR_POOL_CLASSES)
+	{
+		free(buffer);
+		return;
+	}
+
+	JC_Vector_Pool_Thread_Cache* cache = &JC_vector_pool_thread_cache;
+
+	if (cache->count[size_class] < JC_vector_pool_thread_limit)
+	{
+		if (!cache->registered)
+			JC_vector_pool_register_thread(cache);
+
+		cache->buffers[size_class][cache->count[size_class]] = buffer;
+		cache->count[size_class]++;
+		return;
+	}
+
+	JC_vector_pool_lock();
+	if (JC_vector_pool_shared.count[size_class] < JC_vector_pool_shared_limit)
+	{
+		*(void**)buffer = JC_vector_pool_shared.head[size_class];
+		JC_vector_pool_shared.head[size_class] = buffer;
+		JC_vector_pool_shared.count[size_class]++;
+		JC_vector_pool_unlock();
+		return;
+	}
+	JC_vector_pool_unlock();
+
+	free(buffer);
+}
+
+
+// Frees every buffer cached by the calling thread and in the shared list. Buffers cached by other running threads are left
+// alone, and reach the shared list when those threads exit. Returns the amount of buffers freed
+static inline size_t JC_vector_pool_trim(void)
+{
+	size_t freed = 0;
+	JC_Vector_Pool_Thread_Cache* cache = &JC_vector_pool_thread_cache;
+
+	for (size_t size_class = 0; size_class < JC_C_VECTOR_POOL_CLASSES; size_class++)
+	{
+		for (size_t i = 0; i < cache->count[size_class]; i++)
+			free(cache->buffers[size_class][i]);
+
+		freed += cache->count[size_class];
+		cache->count[size_class] = 0;
+	}
+
+	JC_vector_pool_lock();
+	for (size_t size_class = 0; size_class < JC_C_VECTOR_POOL_CLASSES; size_class++)
+	{
+		while (JC_vector_pool_shared.head[size_class] != NULL)
+		{
+			void* buffer = JC_vector_pool_shared.head[size_class];
+			JC_vector_pool_shared.head[size_class] = *(void**)buffer;
+			free(buffer);
+			freed++;
+		}
+
+		JC_vector_pool_shared.count[size_class] = 0;
+	}
+	JC_vector_pool_unlock();
+
+	return freed;
+}
+
+
+
+
+
+
+// ---------------------------------------------------------------------------
+//								Memory Accounting
+// ---------------------------------------------------------------------------
+
+// Called when growing a vector would go over the memory budget, on the thread doing the growing. Should free at least
+// bytes_needed bytes of vector storage that thread owns, for example by destructing cached vectors, and return how many bytes
+// it freed. JC_vector_trim_all() is only safe here if no other thread uses tracked vectors
+typedef size_t (*JC_Vector_Reclaim_Callback)(size_t bytes_needed, void* context);
+
+
+// allocated_bytes is the sum of capacity * type_size over every vector, and is kept up to date for every vector.
+// Tracked vectors are also linked into a list through the registry sentinel, so their used bytes can be added up and their
+// idle capacity trimmed. Tracking costs a lock on construct and destruct, so it's opt in
+static atomic_size_t JC_vector_memory_allocated_bytes = 0;
+static size_t JC_vector_memory_budget = 0;
+static bool JC_vector_memory_tracking = false;
+
+static JC_Vector_Reclaim_Callback JC_vector_memory_reclaimers[JC_C_VECTOR_MEMORY_MAX_RECLAIMERS];
+static void* JC_vector_memory_reclaimer_contexts[JC_C_VECTOR_MEMORY_MAX_RECLAIMERS];
+static size_t JC_vector_memory_reclaimer_count = 0;
+static JC_C_VECTOR_THREAD_LOCAL bool JC_vector_memory_reclaiming = false;
+
+static atomic_flag JC_vector_registry_lock_flag = ATOMIC_FLAG_INIT;
+static JC_Vector JC_vector_registry = { 0, 0, 0, NULL, NULL, &JC_vector_registry, &JC_vector_registry, 0 };
+
+
+// 0 means no budget. Should be set before other threads start using vectors
+static inline void JC_vector_memory_set_budget(const size_t bytes)
+{
+	JC_vector_memory_budget = bytes;
+}
+
+
+// Vectors constructed or adopted while tracking is on are tracked until they are destructed
+static inline void JC_vector_memory_track(const bool track)
+{
+	JC_vector_memory_tracking = track;
+}
+
+
+// Reclaimers are called in the order they were added. Should be added before other threads start using vectors.
+// Returns false if JC_C_VECTOR_MEMORY_MAX_RECLAIMERS have already been added
+static inline bool JC_vector_memory_add_reclaimer(const JC_Vector_Reclaim_Callback callback, void* const context)
+{
+	if (JC_vector_memory_reclaimer_count == JC_C_VECTOR_MEMORY_MAX_RECLAIMERS)
+		return false;
+
+	JC_vector_memory_reclaimers[JC_vector_memory_reclaimer_count] = callback;
+	JC_vector_memory_reclaimer_contexts[JC_vector_memory_reclaimer_count] = context;
+	JC_vector_memory_reclaimer_count++;
+
+	return true;
+}
+
+
+static inline void JC_vector_memory_clear_reclaimers(void)
+{
+	JC_vector_memory_reclaimer_count = 0;
+}
+
+
+static inline size_t JC_vector_memory_allocated(void)
+{
+	return atomic_load_explicit(&JC_vector_memory_allocated_bytes, memory_order_relaxed);
+}
+
+
+static inline bool JC_vector_memory_try_charge(const size_t bytes)
+{
+	size_t current = atomic_load_explicit(&JC_vector_memory_allocated_bytes, memory_order_relaxed);
+
+	do
+	{
+		if (JC_vector_memory_budget != 0 && current + bytes > JC_vector_memory_budget)
+			return false;
+	}
+	while (!atomic_compare_exchange_weak_explicit(&JC_vector_memory_allocated_bytes, &current, current + bytes, memory_order_relaxed, memory_order_relaxed));
+
+	return true;
+}
+
+
+// Counts bytes of new vector storage against the budget. If they don't fit, the reclaimers are called one at a time until
+// they do. Reclaimers which grow vectors themselves don't call the reclaimers again, they just fail once over the budget
+static inline bool JC_vector_memory_charge(const size_t bytes)
+{
+	if (JC_vector_memory_try_charge(bytes))
+		return true;
+
+	if (JC_vector_memory_reclaiming)
+		return false;
+
+	bool charged = false;
+	JC_vector_memory_reclaiming = true;
+
+	for (size_t i = 0; i < JC_vector_memory_reclaimer_count && !charged; i++)
+	{
+		JC_vector_memory_reclaimers[i](bytes, JC_vector_memory_reclaimer_contexts[i]);
+		charged = JC_vector_memory_try_charge(bytes);
+	}
+
+	JC_vector_memory_reclaiming = false;
+	return charged;
+}
+
+
+// For storage that has already been allocated, such as the extra room of a pooled buffer, so it's never refused
+static inline void JC_vector_memory_add(const size_t bytes)
+{
+	atomic_fetch_add_explicit(&JC_vector_memory_allocated_bytes, bytes, memory_order_relaxed);
+}
+
+static inline void JC_vector_memory_uncharge(const size_t bytes)
+{
+	atomic_fetch_sub_explicit(&JC_vector_memory_allocated_bytes, bytes, memory_order_relaxed);
+}
+
+
+// Corrects the count for a vector which has been counted as accounted bytes but ended up holding actual bytes
+static inline void JC_vector_memory_settle(const size_t accounted, const size_t actual)
+{
+	if (actual > accounted)
+		JC_vector_memory_add(actual - accounted);
+	else
+		JC_vector_memory_uncharge(accounted - actual);
+}
+
+
+static inline void JC_vector_registry_lock(void)
+{
+	while (atomic_flag_test_and_set_explicit(&JC_vector_registry_lock_flag, memory_order_acquire))
+		;
+}
+
+static inline void JC_vector_registry_unlock(void)
+{
+	atomic_flag_clear_explicit(&JC_vector_registry_lock_flag, memory_order_release);
+}
+
+
+// Tracks the vector if tracking is on. Every vector has to go through this once when it's created
+static inline void JC_vector_registry_add(JC_Vector* const vector)
+{
+	vector->registry_previous = NULL;
+	vector->registry_next = NULL;
+
+	if (!JC_vector_memory_tracking)
+		return;
+
+	JC_vector_registry_lock();
+	vector->registry_previous = &JC_vector_registry;
+	vector->registry_next = JC_vector_registry.registry_next;
+	JC_vector_registry.registry_next->registry_previous = vector;
+	JC_vector_registry.registry_next = vector;
+	JC_vector_registry_unlock();
+}
+
+static inline void JC_vector_registry_remove(JC_Vector* const vector)
+{
+	if (vector->registry_next == NULL)
+		return;
+
+	JC_vector_registry_lock();
+	vector->registry_previous->registry_next = vector->registry_next;
+	vector->registry_next->registry_previous = vector->registry_previous;
+	JC_vector_registry_unlock();
+
+	vector->registry_previous = NULL;
+	vector->registry_next = NULL;
+}
+
+
+
+
+
+
 // ---------------------------------------------------------------------------
 //							Setup and Cleanup
 // ---------------------------------------------------------------------------
 
-inline JC_Vector* JC_vector_construct(size_t size, size_t type_size)
+static inline JC_Vector* JC_vector_construct(size_t size, size_t type_size)
 {
-	JC_Vector* new_vector = malloc(sizeof(JC_Vector));
+	size_t header_bytes;
+	JC_Vector* new_vector = JC_vector_buffer_alloc(sizeof(JC_Vector), &header_bytes);
 
 	if (new_vector == NULL)
 	{
 		return NULL;
 	}
 
+	new_vector->header_bytes = header_bytes;
+
 	if (size < JC_C_VECTOR_MIN_ELEMENTS)
 	{
 		size = JC_C_VECTOR_MIN_ELEMENTS;
 	}
 
-	if (size * type_size > JC_C_VECTOR_MAX_SIZE)
+	if (size * type_size > JC_C_VECTOR_MAX_SIZE || !JC_vector_memory_charge(size * type_size))
 	{
+		JC_vector_buffer_free(new_vector, header_bytes);
 		return NULL;
 	}
 
 	new_vector->capacity = size;
 	new_vector->type_size = type_size;
 	new_vector->allocated = 0;
+	new_vector->ops = JC_vector_ops_for_size(type_size);
 
 	if (size == 0) {
 		new_vector->data = NULL;
 	}
 	else {
-		new_vector->data = malloc(size * type_size);
+		size_t usable;
+		new_vector->data = JC_vector_buffer_alloc(size * type_size, &usable);
+
+		if (new_vector->data == NULL)
+		{
+			JC_vector_memory_uncharge(size * type_size);
+			JC_vector_buffer_free(new_vector, header_bytes);
+			return NULL;
+		}
+
+		// a pooled buffer may be bigger than requested, and the extra room is given to the vector
+		if (type_size != 0)
+		{
+			new_vector->capacity = usable / type_size;
+			JC_vector_memory_add((new_vector->capacity - size) * type_size);
+		}
 	}
 
+	JC_vector_registry_add(new_vector);
+
 	return new_vector;
 }
 
-inline void JC_vector_destruct(JC_Vector** const restrict vector)
+static inline void JC_vector_destruct(JC_Vector** const restrict vector)
 {
 	if (vector == NULL || *vector == NULL)
 		return;
 
-	free((*vector)->data);
+	JC_vector_registry_remove(*vector);
+	JC_vector_memory_uncharge((*vector)->capacity * (*vector)->type_size);
+
+	JC_vector_buffer_free((*vector)->data, (*vector)->capacity * (*vector)->type_size);
 
-	free(*vector);
+	JC_vector_buffer_free(*vector, (*vector)->header_bytes);
 	*vector = NULL;
 }
 
@@ -88,7 +691,7 @@ inline void JC_vector_destruct(JC_Vector** const restrict vector)
 //									Element Access
 // --------------------------------------------------------------------------------
 
-inline char* JC_vector_at_ptr(const JC_Vector* const restrict vector, const size_t index) {
+static inline char* JC_vector_at_ptr(const JC_Vector* const restrict vector, const size_t index) {
 	if (index >= vector->allocated) {
 		return NULL;
 	}
@@ -97,12 +700,12 @@ inline char* JC_vector_at_ptr(const JC_Vector* const restrict vector, const size
 }
 
 
-inline char* JC_vector_at_ptr_unsafe(const JC_Vector* const restrict vector, const size_t index) {
+static inline char* JC_vector_at_ptr_unsafe(const JC_Vector* const restrict vector, const size_t index) {
 	return vector->data + (index * vector->type_size);
 }
 
 
-inline char* JC_vector_front(const JC_Vector* const restrict vector)
+static inline char* JC_vector_front(const JC_Vector* const restrict vector)
 {
 	if (vector->allocated == 0)
 		return NULL;
@@ -111,7 +714,7 @@ inline char* JC_vector_front(const JC_Vector* const restrict vector)
 }
 
 
-inline char* JC_vector_back(const JC_Vector* const restrict vector)
+static inline char* JC_vector_back(const JC_Vector* const restrict vector)
 {
 	if (vector->allocated == 0)
 		return NULL;
@@ -119,7 +722,7 @@ inline char* JC_vector_back(const JC_Vector* const restrict vector)
 	return vector->data + ((vector->allocated - 1) * vector->type_size);
 }
 
-inline char* JC_vector_data(const JC_Vector* const restrict vector)
+static inline char* JC_vector_data(const JC_Vector* const restrict vector)
 {
 	return vector->data;
 }
@@ -129,26 +732,126 @@ inline char* JC_vector_data(const JC_Vector* const restrict vector)
 
 
 
+// --------------------------------------------------------------------------------
+//								Batch Element Access
+// --------------------------------------------------------------------------------
+
+// Every index is checked before anything is copied, so a batch either completes or leaves out untouched
+static inline bool JC_vector_indices_in_bounds(const JC_Vector* const restrict vector, const size_t* const restrict indices, const size_t count)
+{
+	size_t max_index = 0;
+
+	for (size_t i = 0; i < count; i++)
+	{
+		if (indices[i] > max_index)
+			max_index = indices[i];
+	}
+
+	return count == 0 || max_index < vector->allocated;
+}
+
+
+static inline bool JC_vector_gather(const JC_Vector* const restrict vector, const size_t* const restrict indices, const size_t count, void* const restrict out)
+{
+	if (!JC_vector_indices_in_bounds(vector, indices, count))
+		return false;
+
+	const size_t type_size = vector->type_size;
+	const char* const data = vector->data;
+	char* out_position = out;
+	size_t i = 0;
+
+#if defined(__AVX2__) && SIZE_MAX == UINT64_MAX
+	if (type_size == 4)
+	{
+		for (; i + 4 <= count; i += 4)
+		{
+			// one prefetch per lane, so all 4 lines the gather will touch are on their way
+			for (size_t lane = 0; lane < 4 && i + JC_C_VECTOR_PREFETCH_DISTANCE + lane < count; lane++)
+				JC_C_VECTOR_PREFETCH(data + indices[i + JC_C_VECTOR_PREFETCH_DISTANCE + lane] * 4, 0);
+
+			__m256i index_lanes = _mm256_loadu_si256((const __m256i*)(indices + i));
+			_mm_storeu_si128((__m128i*)(out_position + i * 4), _mm256_i64gather_epi32((const int*)data, index_lanes, 4));
+		}
+	}
+	else if (type_size == 8)
+	{
+		for (; i + 4 <= count; i += 4)
+		{
+			// one prefetch per lane, so all 4 lines the gather will touch are on their way
+			for (size_t lane = 0; lane < 4 && i + JC_C_VECTOR_PREFETCH_DISTANCE + lane < count; lane++)
+				JC_C_VECTOR_PREFETCH(data + indices[i + JC_C_VECTOR_PREFETCH_DISTANCE + lane] * 8, 0);
+
+			__m256i index_lanes = _mm256_loadu_si256((const __m256i*)(indices + i));
+			_mm256_storeu_si256((__m256i*)(out_position + i * 8), _mm256_i64gather_epi64((const long long*)data, index_lanes, 8));
+		}
+	}
+#endif
+
+	for (; i + JC_C_VECTOR_PREFETCH_DISTANCE < count; i++)
+	{
+		JC_C_VECTOR_PREFETCH(data + indices[i + JC_C_VECTOR_PREFETCH_DISTANCE] * type_size, 0);
+		memcpy(out_position + i * type_size, data + indices[i] * type_size, type_size);
+	}
+
+	for (; i < count; i++)
+	{
+		memcpy(out_position + i * type_size, data + indices[i] * type_size, type_size);
+	}
+
+	return true;
+}
+
+
+static inline bool JC_vector_scatter(JC_Vector* const restrict vector, const size_t* const restrict indices, const size_t count, const void* const restrict values)
+{
+	if (!JC_vector_indices_in_bounds(vector, indices, count))
+		return false;
+
+	const size_t type_size = vector->type_size;
+	char* const data = vector->data;
+	const char* value_position = values;
+	size_t i = 0;
+
+	for (; i + JC_C_VECTOR_PREFETCH_DISTANCE < count; i++)
+	{
+		JC_C_VECTOR_PREFETCH(data + indices[i + JC_C_VECTOR_PREFETCH_DISTANCE] * type_size, 1);
+		memcpy(data + indices[i] * type_size, value_position + i * type_size, type_size);
+	}
+
+	for (; i < count; i++)
+	{
+		memcpy(data + indices[i] * type_size, value_position + i * type_size, type_size);
+	}
+
+	return true;
+}
+
+
+
+
+
+
 // -----------------------------------------------------------------------------
 //								Iterators
 // -----------------------------------------------------------------------------
 
-inline char* JC_vector_begin(const JC_Vector* const restrict vector)
+static inline char* JC_vector_begin(const JC_Vector* const restrict vector)
 {
 	return vector->data;
 }
 
-inline const char* JC_vector_cbegin(const JC_Vector* const restrict vector)
+static inline const char* JC_vector_cbegin(const JC_Vector* const restrict vector)
 {
 	return vector->data;
 }
 
-inline char* JC_vector_end(const JC_Vector* const restrict vector)
+static inline char* JC_vector_end(const JC_Vector* const restrict vector)
 {
 	return vector->data + (vector->allocated * vector->type_size);
 }
 
-inline const char* JC_vector_cend(const JC_Vector* const restrict vector)
+static inline const char* JC_vector_cend(const JC_Vector* const restrict vector)
 {
 	return vector->data + (vector->allocated * vector->type_size);
 }
@@ -162,23 +865,23 @@ inline const char* JC_vector_cend(const JC_Vector* const restrict vector)
 //									Capacity
 // -----------------------------------------------------------------------------
 
-inline bool JC_vector_empty(const JC_Vector* const restrict vector)
+static inline bool JC_vector_empty(const JC_Vector* const restrict vector)
 {
 	return !vector->allocated;
 }
 
-inline size_t JC_vector_size(const JC_Vector* const restrict vector)
+static inline size_t JC_vector_size(const JC_Vector* const restrict vector)
 {
 	return vector->allocated;
 }
 
-inline size_t JC_vector_max_size()
+static inline size_t JC_vector_max_size()
 {
 	return JC_C_VECTOR_MAX_SIZE;
 }
 
 
-inline bool JC_vector_reserve(JC_Vector* const restrict vector, const size_t size)
+static inline bool JC_vector_reserve(JC_Vector* const restrict vector, const size_t size)
 {
 
 	if (size <= vector->capacity)
@@ -188,30 +891,43 @@ inline bool JC_vector_reserve(JC_Vector* const restrict vector, const size_t siz
 		return false;
 
 
-	void* temp_data = malloc(size * vector->type_size);
+	const size_t charge = size * vector->type_size - vector->capacity * vector->type_size;
+
+	if (!JC_vector_memory_charge(charge))
+		return false;
+
+	// read after charging, since a reclaimer may have trimmed this vector
+	const size_t accounted = vector->capacity * vector->type_size + charge;
+
+	size_t usable;
+	void* temp_data = JC_vector_buffer_alloc(size * vector->type_size, &usable);
 
 	if (temp_data == NULL) {
+		JC_vector_memory_uncharge(charge);
 		return false;
 	}
 
-	memcpy(temp_data, vector->data, vector->capacity * vector->type_size);
+	if (vector->data != NULL)
+		memcpy(temp_data, vector->data, vector->capacity * vector->type_size);
 
-	free(vector->data);
+	JC_vector_buffer_free(vector->data, vector->capacity * vector->type_size);
 	vector->data = temp_data;
-	vector->capacity = size;
+	vector->capacity = vector->type_size ? usable / vector->type_size : size;
+
+	JC_vector_memory_settle(accounted, vector->capacity * vector->type_size);
 
 	return true;
 
 }
 
 
-inline size_t JC_vector_capacity(const JC_Vector* const restrict vector)
+static inline size_t JC_vector_capacity(const JC_Vector* const restrict vector)
 {
 	return vector->capacity;
 }
 
 
-inline bool JC_vector_shrink_to_fit(JC_Vector* restrict vector)
+static inline bool JC_vector_shrink_to_fit(JC_Vector* restrict vector)
 {
 	void* new_data;
 
@@ -228,6 +944,8 @@ inline bool JC_vector_shrink_to_fit(JC_Vector* restrict vector)
 	if (new_data == NULL)
 		return false;
 
+	JC_vector_memory_uncharge((vector->capacity - vector->allocated) * vector->type_size);
+
 	vector->data = new_data;
 	vector->capacity = vector->allocated;
 	return true;
@@ -243,14 +961,14 @@ inline bool JC_vector_shrink_to_fit(JC_Vector* restrict vector)
 // -----------------------------------------------------------------------------
 
 
-inline void JC_vector_clear(JC_Vector* const restrict vector)
+static inline void JC_vector_clear(JC_Vector* const restrict vector)
 {
 	// TODO - When updating to add object oriented features, update here to use destructor
 	vector->allocated = 0;
 }
 
 
-inline char* JC_vector_insert_ptr(JC_Vector* const restrict vector, const size_t index, const void* const restrict value)
+static inline char* JC_vector_insert_ptr(JC_Vector* const restrict vector, const size_t index, const void* const restrict value)
 {
 	if (index > vector->allocated)
 		return NULL;
@@ -266,10 +984,10 @@ inline char* JC_vector_insert_ptr(JC_Vector* const restrict vector, const size_t
 	char* insert_position = vector->data + (index * vector->type_size);
 
 	// move all other data to make room for the inserted element
-	memmove(insert_position + (1 * vector->type_size), insert_position, (vector->allocated - index) * vector->type_size);
+	vector->ops->shift(insert_position + (1 * vector->type_size), insert_position, vector->allocated - index, vector->type_size);
 
 	// insert the value into position
-	memcpy(insert_position, value, vector->type_size);
+	vector->ops->copy(insert_position, value, vector->type_size);
 
 	vector->allocated++;
 
@@ -277,21 +995,21 @@ inline char* JC_vector_insert_ptr(JC_Vector* const restrict vector, const size_t
 }
 
 
-inline char* JC_vector_erase(JC_Vector* const restrict vector, const size_t index)
+static inline char* JC_vector_erase(JC_Vector* const restrict vector, const size_t index)
 {
 	if (index >= vector->allocated)
 		return NULL;
 
 	char* erase_position = vector->data + (index * vector->type_size);
 
-	memmove(erase_position, erase_position + vector->type_size, (vector->allocated - index - 1) * vector->type_size);
+	vector->ops->shift(erase_position, erase_position + vector->type_size, vector->allocated - index - 1, vector->type_size);
 
 	vector->allocated--;
 	return erase_position;
 }
 
 
-inline bool JC_vector_pushback_ptr(JC_Vector* const restrict vector, const void* const restrict data)
+static inline bool JC_vector_pushback_ptr(JC_Vector* const restrict vector, const void* const restrict data)
 {
 
 	if (vector->allocated == vector->capacity)
@@ -302,14 +1020,14 @@ inline bool JC_vector_pushback_ptr(JC_Vector* const restrict vector, const void*
 		}
 	}
 
-	memcpy(vector->data + (vector->allocated * vector->type_size), data, vector->type_size);
+	vector->ops->copy(vector->data + (vector->allocated * vector->type_size), data, vector->type_size);
 	vector->allocated++;
 
 	return true;
 }
 
 
-inline void JC_vector_pop_back(JC_Vector* const restrict vector)
+static inline void JC_vector_pop_back(JC_Vector* const restrict vector)
 {
 	if (vector->allocated == 0)
 		return;
@@ -318,7 +1036,7 @@ inline void JC_vector_pop_back(JC_Vector* const restrict vector)
 }
 
 
-inline bool JC_vector_resize(JC_Vector* const restrict vector, const size_t new_size)
+static inline bool JC_vector_resize(JC_Vector* const restrict vector, const size_t new_size)
 {
 
 	if (new_size <= vector->allocated)
@@ -335,14 +1053,14 @@ inline bool JC_vector_resize(JC_Vector* const restrict vector, const size_t new_
 
 	size_t allocated_difference = new_size - vector->allocated;
 	// "default-inserted" value is simply assumed to be zero in the case no explicit value is provided
-	memset(vector->data + vector->allocated, 0, allocated_difference * vector->type_size);
+	memset(vector->data + (vector->allocated * vector->type_size), 0, allocated_difference * vector->type_size);
 
 	vector->allocated = new_size;
 	return true;
 }
 
 
-inline bool JC_vector_resize_ptr(JC_Vector* const restrict vector, const size_t new_size, const void* const restrict default_value)
+static inline bool JC_vector_resize_ptr(JC_Vector* const restrict vector, const size_t new_size, const void* const restrict default_value)
 {
 
 	if (new_size <= vector->allocated)
@@ -359,10 +1077,7 @@ inline bool JC_vector_resize_ptr(JC_Vector* const restrict vector, const size_t
 
 	size_t allocated_difference = new_size - vector->allocated;
 
-	for (size_t i = vector->allocated; i < new_size; i++)
-	{
-		memcpy(vector->data + (i * vector->type_size), default_value, vector->type_size);
-	}
+	vector->ops->fill(vector->data + (vector->allocated * vector->type_size), default_value, allocated_difference, vector->type_size);
 
 	vector->allocated = new_size;
 	return true;
@@ -381,6 +1096,190 @@ void JC_vector_swap(JC_Vector** const restrict vector1, JC_Vector** const restri
 
 
 
+// --------------------------------------------------------------------------------
+//									Buffer Transfer
+// --------------------------------------------------------------------------------
+
+// Wraps a buffer from malloc() holding count elements, with room for capacity, in a new vector without copying it.
+// The vector owns the buffer from then on, and frees it when destructed
+static inline JC_Vector* JC_vector_adopt(void* const buffer, const size_t count, const size_t capacity, const size_t type_size)
+{
+	if (count > capacity || capacity * type_size > JC_C_VECTOR_MAX_SIZE)
+		return NULL;
+
+	size_t header_bytes;
+	JC_Vector* new_vector = JC_vector_buffer_alloc(sizeof(JC_Vector), &header_bytes);
+
+	if (new_vector == NULL)
+	{
+		return NULL;
+	}
+
+	new_vector->header_bytes = header_bytes;
+	new_vector->capacity = buffer == NULL ? 0 : capacity;
+	new_vector->allocated = buffer == NULL ? 0 : count;
+	new_vector->type_size = type_size;
+	new_vector->data = buffer;
+	new_vector->ops = JC_vector_ops_for_size(type_size);
+
+	// the buffer already exists, so it's counted even if it goes over the budget
+	JC_vector_memory_add(new_vector->capacity * type_size);
+	JC_vector_registry_add(new_vector);
+
+	return new_vector;
+}
+
+
+// Hands the vector's buffer to the caller, who has to free() it, and leaves the vector empty with no buffer.
+// The vector can still be used, and allocates a new buffer the next time it grows
+static inline void* JC_vector_release(JC_Vector* const restrict vector, size_t* const restrict count, size_t* const restrict capacity)
+{
+	void* buffer = vector->data;
+
+	if (count != NULL)
+		*count = vector->allocated;
+	if (capacity != NULL)
+		*capacity = vector->capacity;
+
+	JC_vector_memory_uncharge(vector->capacity * vector->type_size);
+
+	vector->data = NULL;
+	vector->allocated = 0;
+	vector->capacity = 0;
+
+	return buffer;
+}
+
+
+static inline void JC_vector_swap_buffers(JC_Vector* const restrict vector1, JC_Vector* const restrict vector2)
+{
+	char* temp_data = vector1->data;
+	size_t temp_capacity = vector1->capacity;
+	size_t temp_allocated = vector1->allocated;
+
+	vector1->data = vector2->data;
+	vector1->capacity = vector2->capacity;
+	vector1->allocated = vector2->allocated;
+
+	vector2->data = temp_data;
+	vector2->capacity = temp_capacity;
+	vector2->allocated = temp_allocated;
+}
+
+
+// Moves every element of source into destination before index, leaving source empty. Buffers are handed over instead of
+// copied where that's possible. When destination is empty it takes source's buffer outright, and when inserting at the front
+// of a smaller destination whose elements fit in source's spare room, destination's elements are copied over and it takes
+// source's buffer. Otherwise source's elements are copied into destination. A vector can't be spliced into itself
+static inline bool JC_vector_splice(JC_Vector* const destination, const size_t index, JC_Vector* const source)
+{
+	if (destination == source || index > destination->allocated || destination->type_size != source->type_size)
+		return false;
+
+	const size_t type_size = destination->type_size;
+	const size_t total = destination->allocated + source->allocated;
+
+	if (source->allocated == 0)
+		return true;
+
+	if (destination->allocated == 0)
+	{
+		JC_vector_swap_buffers(destination, source);
+		source->allocated = 0;
+		return true;
+	}
+
+	if (index == 0 && destination->allocated < source->allocated && total <= source->capacity)
+	{
+		memcpy(source->data + source->allocated * type_size, destination->data, destination->allocated * type_size);
+		source->allocated = total;
+
+		JC_vector_swap_buffers(destination, source);
+		source->allocated = 0;
+		return true;
+	}
+
+	if (total > destination->capacity && !JC_vector_reserve(destination, total))
+		return false;
+
+	char* insert_position = destination->data + index * type_size;
+
+	memmove(insert_position + source->allocated * type_size, insert_position, (destination->allocated - index) * type_size);
+	memcpy(insert_position, source->data, source->allocated * type_size);
+
+	destination->allocated = total;
+	source->allocated = 0;
+
+	return true;
+}
+
+
+static inline bool JC_vector_concat(JC_Vector* const destination, JC_Vector* const source)
+{
+	return JC_vector_splice(destination, destination->allocated, source);
+}
+
+
+
+
+
+
+// --------------------------------------------------------------------------------
+//									Memory Reclaim
+// --------------------------------------------------------------------------------
+
+typedef struct JC_Vector_Memory_Stats
+{
+	size_t allocated_bytes;			// capacity of every vector
+	size_t tracked_vectors;
+	size_t tracked_allocated_bytes;	// capacity of the tracked vectors
+	size_t tracked_used_bytes;		// size of the tracked vectors
+}
+JC_Vector_Memory_Stats;
+
+
+// Must not run while another thread is resizing a tracked vector
+static inline JC_Vector_Memory_Stats JC_vector_memory_stats(void)
+{
+	JC_Vector_Memory_Stats stats = { JC_vector_memory_allocated(), 0, 0, 0 };
+
+	JC_vector_registry_lock();
+	for (JC_Vector* vector = JC_vector_registry.registry_next; vector != &JC_vector_registry; vector = vector->registry_next)
+	{
+		stats.tracked_vectors++;
+		stats.tracked_allocated_bytes += vector->capacity * vector->type_size;
+		stats.tracked_used_bytes += vector->allocated * vector->type_size;
+	}
+	JC_vector_registry_unlock();
+
+	return stats;
+}
+
+
+// Shrinks every tracked vector with at least min_idle_bytes of unused capacity down to its size, and returns how many bytes
+// were given back. Must not run while another thread is using a tracked vector, which includes running it from a reclaimer
+// while other threads grow their vectors
+static inline size_t JC_vector_trim_all(const size_t min_idle_bytes)
+{
+	size_t before = JC_vector_memory_allocated();
+
+	JC_vector_registry_lock();
+	for (JC_Vector* vector = JC_vector_registry.registry_next; vector != &JC_vector_registry; vector = vector->registry_next)
+	{
+		if ((vector->capacity - vector->allocated) * vector->type_size >= min_idle_bytes && vector->capacity > vector->allocated)
+			JC_vector_shrink_to_fit(vector);
+	}
+	JC_vector_registry_unlock();
+
+	size_t after = JC_vector_memory_allocated();
+	return before > after ? before - after : 0;
+}
+
+
+
+
+
+
 // --------------------------------------------------------------------------------
 //						Other functions (non member in C++)
 // --------------------------------------------------------------------------------
@@ -402,7 +1301,7 @@ bool JC_vector_are_same_shallow(JC_Vector* const restrict vector1, JC_Vector* co
 }
 
 
-inline int JC_vector_erase_if_same(JC_Vector* const restrict vector, const void* const restrict value)
+static inline int JC_vector_erase_if_same(JC_Vector* const restrict vector, const void* const restrict value)
 {
 	int num_erased = 0;
 
@@ -420,7 +1319,7 @@ inline int JC_vector_erase_if_same(JC_Vector* const restrict vector, const void*
 }
 
 
-inline int JC_vector_erase_if_predicate(JC_Vector* const restrict vector, bool predicate_function())
+static inline int JC_vector_erase_if_predicate(JC_Vector* const restrict vector, bool predicate_function())
 {
 	int num_erased = 0;
 
@@ -0,0 +1,521 @@
+#ifndef JC_C_VECTOR_NUMA_H_FILE
+#define JC_C_VECTOR_NUMA_H_FILE
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdio.h>
+#include "JC_C_Vector.h"
+#include "JC_C_Vector_Parallel.h"
+
+#if defined(__linux__)
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
+
+#if defined(__linux__) && defined(SYS_mbind)
+#define JC_C_VECTOR_NUMA_SUPPORTED 1
+#else
+#define JC_C_VECTOR_NUMA_SUPPORTED 0
+#endif
+
+#if JC_C_VECTOR_NUMA_SUPPORTED
+// unistd.h only declares this with _GNU_SOURCE, which can't be relied on once other headers are included
+long syscall(long number, ...);
+#endif
+
+// Memory policy modes and flags from the Linux mbind interface, so that libnuma isn't needed
+#define JC_C_VECTOR_NUMA_MPOL_BIND 2
+#define JC_C_VECTOR_NUMA_MPOL_INTERLEAVE 3
+#define JC_C_VECTOR_NUMA_MPOL_MF_MOVE 2
+#define JC_C_VECTOR_NUMA_MPOL_F_ADDR 2
+
+// Passing this as the node mask means every node
+#define JC_C_VECTOR_NUMA_ALL_NODES 0
+
+// Largest amount of nodes and processors the topology is read for. Anything past these is ignored
+#define JC_C_VECTOR_NUMA_MAX_NODES 64
+#define JC_C_VECTOR_NUMA_MAX_CPUS 1024
+#define JC_C_VECTOR_NUMA_CPU_WORDS (JC_C_VECTOR_NUMA_MAX_CPUS / (8 * sizeof(unsigned long)))
+
+
+
+
+typedef enum JC_Vector_NUMA_Policy
+{
+	JC_VECTOR_NUMA_DEFAULT,		// pages go to the node of the thread which first writes them
+	JC_VECTOR_NUMA_BIND,		// pages only go to the nodes in the mask
+	JC_VECTOR_NUMA_INTERLEAVE	// pages are spread round robin across the nodes in the mask
+}
+JC_Vector_NUMA_Policy;
+
+
+typedef struct JC_Vector_Fill_Context
+{
+	JC_Vector* vector;
+	const void* value;
+}
+JC_Vector_Fill_Context;
+
+
+typedef struct JC_Vector_Copy_Context
+{
+	char* destination;
+	const char* source;
+	size_t type_size;
+}
+JC_Vector_Copy_Context;
+
+
+// Splits the first writes to a buffer between threads. Each element goes to the node JC_vector_numa_node_of() gives for its
+// index out of capacity, and the thread writing it is moved onto that node's processors while it does
+typedef struct JC_Vector_First_Touch
+{
+	size_t capacity;
+	size_t start;
+	JC_Vector_Parallel_Task touch;
+	void* context;
+}
+JC_Vector_First_Touch;
+
+
+// Processors of each online node, in order of node id, read once from /sys
+static unsigned long JC_vector_numa_node_cpus[JC_C_VECTOR_NUMA_MAX_NODES][JC_C_VECTOR_NUMA_CPU_WORDS];
+static size_t JC_vector_numa_node_total = 1;
+static once_flag JC_vector_numa_topology_once = ONCE_FLAG_INIT;
+
+
+
+
+
+
+// ---------------------------------------------------------------------------
+//								Node Topology
+// ---------------------------------------------------------------------------
+
+// Reads a Linux cpu or node list such as "0-3,8-11" into a mask of bits bits. Returns false if nothing could be read
+static inline bool JC_vector_numa_read_list(const char* const path, unsigned long* const mask, const size_t bits)
+{
+	const size_t word_bits = 8 * sizeof(unsigned long);
+	FILE* file = fopen(path, "r");
+
+	if (file == NULL)
+		return false;
+
+	memset(mask, 0, bits / 8);
+
+	unsigned long first;
+	unsigned long last;
+	bool read_any = false;
+
+	while (fscanf(file, "%lu", &first) == 1)
+	{
+		int separator = fgetc(file);
+		last = first;
+
+		if (separator == '-')
+		{
+			if (fscanf(file, "%lu", &last) != 1)
+				break;
+
+			separator = fgetc(file);
+		}
+
+		for (unsigned long i = first; i <= last && i < bits; i++)
+			mask[i / word_bits] |= 1UL << (i % word_bits);
+
+		read_any = true;
+
+		if (separator != ',')
+			break;
+	}
+
+	fclose(file);
+	return read_any;
+}
+
+
+static inline void JC_vector_numa_load_topology(void)
+{
+	const size_t word_bits = 8 * sizeof(unsigned long);
+	unsigned long online[JC_C_VECTOR_NUMA_MAX_NODES / (8 * sizeof(unsigned long))];
+	size_t total = 0;
+
+	if (!JC_vector_numa_read_list("/sys/devices/system/node/online", online, JC_C_VECTOR_NUMA_MAX_NODES))
+		return;
+
+	for (size_t node = 0; node < JC_C_VECTOR_NUMA_MAX_NODES; node++)
+	{
+		if (!(online[node / word_bits] & (1UL << (node % word_bits))))
+			continue;
+
+		char path[64];
+		snprintf(path, sizeof(path), "/sys/devices/system/node/node%zu/cpulist", node);
+
+		// nodes with memory but no processors can't have threads moved onto them
+		if (JC_vector_numa_read_list(path, JC_vector_numa_node_cpus[total], JC_C_VECTOR_NUMA_MAX_CPUS))
+			total++;
+	}
+
+	JC_vector_numa_node_total = total ? total : 1;
+}
+
+
+// How many nodes have processors. 1 when the topology can't be read
+static inline size_t JC_vector_numa_nodes(void)
+{
+	call_once(&JC_vector_numa_topology_once, JC_vector_numa_load_topology);
+	return JC_vector_numa_node_total;
+}
+
+
+// The node, counted from 0 over the nodes JC_vector_numa_nodes() counts, that the first touch functions place element
+// index of a buffer holding capacity elements on. Contiguous ranges of nearly equal size go to each node in turn
+static inline size_t JC_vector_numa_node_of(const size_t capacity, const size_t index)
+{
+	if (capacity == 0 || index >= capacity)
+		return JC_vector_numa_nodes() - 1;
+
+	return index * JC_vector_numa_nodes() / capacity;
+}
+
+
+static inline bool JC_vector_numa_get_affinity(unsigned long* const mask)
+{
+#if JC_C_VECTOR_NUMA_SUPPORTED && defined(SYS_sched_getaffinity)
+	memset(mask, 0, JC_C_VECTOR_NUMA_CPU_WORDS * sizeof(unsigned long));
+	return syscall(SYS_sched_getaffinity, 0, JC_C_VECTOR_NUMA_CPU_WORDS * sizeof(unsigned long), mask) > 0;
+#else
+	(void)mask;
+	return false;
+#endif
+}
+
+
+static inline bool JC_vector_numa_set_affinity(const unsigned long* const mask)
+{
+#if JC_C_VECTOR_NUMA_SUPPORTED && defined(SYS_sched_setaffinity)
+	return syscall(SYS_sched_setaffinity, 0, JC_C_VECTOR_NUMA_CPU_WORDS * sizeof(unsigned long), mask) == 0;
+#else
+	(void)mask;
+	return false;
+#endif
+}
+
+
+// Moves the calling thread onto the processors of node. Tasks of JC_vector_parallel_for() can call this with
+// JC_vector_numa_node_of() for their range so they read memory the first touch functions placed on their own node.
+// Returns false if node is out of range or the thread couldn't be moved
+static inline bool JC_vector_numa_run_on_node(const size_t node)
+{
+	if (node >= JC_vector_numa_nodes())
+		return false;
+
+	return JC_vector_numa_set_affinity(JC_vector_numa_node_cpus[node]);
+}
+
+
+// Runs touch over one node's part of [begin, end) at a time from that node's processors, then moves the thread back
+static inline void JC_vector_numa_first_touch_task(const size_t task_index, const size_t begin, const size_t end, void* const context_ptr)
+{
+	JC_Vector_First_Touch* context = context_ptr;
+	size_t nodes = JC_vector_numa_nodes();
+	unsigned long previous[JC_C_VECTOR_NUMA_CPU_WORDS];
+
+	if (nodes == 1 || !JC_vector_numa_get_affinity(previous))
+	{
+		context->touch(task_index, context->start + begin, context->start + end, context->context);
+		return;
+	}
+
+	size_t position = context->start + begin;
+	const size_t last = context->start + end;
+
+	while (position < last)
+	{
+		size_t node = JC_vector_numa_node_of(context->capacity, position);
+
+		// the first index of the next node, from index * nodes / capacity rounded the other way
+		size_t node_end = node + 1 == nodes ? last : ((node + 1) * context->capacity + nodes - 1) / nodes;
+
+		if (node_end > last)
+			node_end = last;
+
+		JC_vector_numa_run_on_node(node);
+		context->touch(task_index, position, node_end, context->context);
+
+		position = node_end;
+	}
+
+	JC_vector_numa_set_affinity(previous);
+}
+
+
+// Calls touch(task_index, begin, end, context) over [start, end) split between threads with JC_vector_parallel_run(), with
+// each part written from the node its elements belong to out of a buffer of capacity elements. begin and end are absolute
+static inline void JC_vector_numa_first_touch(const size_t capacity, const size_t start, const size_t end, const size_t type_size, const JC_Vector_Parallel_Task touch, void* const context)
+{
+	JC_Vector_First_Touch first_touch;
+	first_touch.capacity = capacity;
+	first_touch.start = start;
+	first_touch.touch = touch;
+	first_touch.context = context;
+
+	size_t min_per_task = type_size ? JC_C_VECTOR_PARALLEL_MIN_BYTES / type_size : end - start;
+
+	JC_vector_parallel_run(end - start, min_per_task, JC_vector_numa_first_touch_task, &first_touch);
+}
+
+
+
+
+
+
+// ---------------------------------------------------------------------------
+//								NUMA Placement
+// ---------------------------------------------------------------------------
+
+static inline size_t JC_vector_numa_page_size(void)
+{
+	long page_size = 4096;
+
+#if defined(_SC_PAGESIZE)
+	page_size = sysconf(_SC_PAGESIZE);
+#endif
+
+	return page_size > 0 ? (size_t)page_size : 4096;
+}
+
+
+// Applies policy to the pages of buffer, which must be page aligned. Pages which have already been written to are moved.
+// Returns false if the policy couldn't be applied, in which case the buffer is still usable with the default placement
+static inline bool JC_vector_numa_place(void* const buffer, const size_t bytes, const JC_Vector_NUMA_Policy policy, const uint64_t node_mask)
+{
+	if (policy == JC_VECTOR_NUMA_DEFAULT)
+		return true;
+
+#if JC_C_VECTOR_NUMA_SUPPORTED
+	unsigned long nodes = node_mask == JC_C_VECTOR_NUMA_ALL_NODES ? ~0UL : (unsigned long)node_mask;
+	int mode = policy == JC_VECTOR_NUMA_BIND ? JC_C_VECTOR_NUMA_MPOL_BIND : JC_C_VECTOR_NUMA_MPOL_INTERLEAVE;
+
+	// the kernel reads one less node than it's told
+	return syscall(SYS_mbind, buffer, bytes, mode, &nodes, sizeof(nodes) * 8 + 1, JC_C_VECTOR_NUMA_MPOL_MF_MOVE) == 0;
+#else
+	(void)buffer;
+	(void)bytes;
+	(void)node_mask;
+	return false;
+#endif
+}
+
+
+// Finds the policy the pages of buffer were placed with. Anything other than a bind or interleave policy, or a failed lookup,
+// comes back as JC_VECTOR_NUMA_DEFAULT
+static inline JC_Vector_NUMA_Policy JC_vector_numa_policy(const void* const buffer, uint64_t* const node_mask)
+{
+	*node_mask = JC_C_VECTOR_NUMA_ALL_NODES;
+
+#if JC_C_VECTOR_NUMA_SUPPORTED && defined(SYS_get_mempolicy)
+	int mode = 0;
+	unsigned long nodes = 0;
+
+	if (buffer == NULL || syscall(SYS_get_mempolicy, &mode, &nodes, sizeof(nodes) * 8 + 1, buffer, JC_C_VECTOR_NUMA_MPOL_F_ADDR) != 0)
+		return JC_VECTOR_NUMA_DEFAULT;
+
+	*node_mask = nodes == ~0UL ? JC_C_VECTOR_NUMA_ALL_NODES : (uint64_t)nodes;
+
+	if (mode == JC_C_VECTOR_NUMA_MPOL_BIND)
+		return JC_VECTOR_NUMA_BIND;
+
+	if (mode == JC_C_VECTOR_NUMA_MPOL_INTERLEAVE)
+		return JC_VECTOR_NUMA_INTERLEAVE;
+#else
+	(void)buffer;
+#endif
+
+	*node_mask = JC_C_VECTOR_NUMA_ALL_NODES;
+	return JC_VECTOR_NUMA_DEFAULT;
+}
+
+
+static inline void JC_vector_numa_copy_task(const size_t task_index, const size_t begin, const size_t end, void* const context_ptr)
+{
+	(void)task_index;
+
+	JC_Vector_Copy_Context* context = context_ptr;
+	memcpy(context->destination + begin * context->type_size, context->source + begin * context->type_size, (end - begin) * context->type_size);
+}
+
+
+// Moves the vector's elements into a new page aligned buffer with room for at least size elements, with its pages placed
+// by policy. Unlike JC_vector_reserve() the buffer is always replaced, so this also changes the placement of an existing vector.
+// Placement is best effort. If the system doesn't support it the vector keeps the default placement and this still succeeds
+static inline bool JC_vector_reserve_numa(JC_Vector* const restrict vector, size_t size, const JC_Vector_NUMA_Policy policy, const uint64_t node_mask)
+{
+	if (size < vector->capacity)
+		size = vector->capacity;
+
+	if (size * vector->type_size > JC_C_VECTOR_MAX_SIZE)
+		return false;
+
+	size_t page_size = JC_vector_numa_page_size();
+	size_t bytes = (size * vector->type_size + page_size - 1) / page_size * page_size;
+
+	if (bytes == 0)
+		bytes = page_size;
+
+	const size_t old_bytes = vector->capacity * vector->type_size;
+	const size_t charge = bytes > old_bytes ? bytes - old_bytes : 0;
+
+	if (charge != 0 && !JC_vector_memory_charge(charge))
+		return false;
+
+	// read after charging, since a reclaimer may have trimmed this vector
+	const size_t accounted = vector->capacity * vector->type_size + charge;
+
+	char* temp_data = aligned_alloc(page_size, bytes);
+
+	if (temp_data == NULL) {
+		JC_vector_memory_uncharge(charge);
+		return false;
+	}
+
+	// placed before anything is copied in, so that no page is faulted in on the wrong node first
+	JC_vector_numa_place(temp_data, bytes, policy, node_mask);
+
+	// whatever is left of the last page is given to the vector, as long as it stays within JC_C_VECTOR_MAX_SIZE
+	size_t usable = bytes < JC_C_VECTOR_MAX_SIZE ? bytes : JC_C_VECTOR_MAX_SIZE;
+	size_t capacity = vector->type_size ? usable / vector->type_size : size;
+
+	// with the default policy each part is first touched from the node JC_vector_numa_node_of() gives it in the new buffer,
+	// rather than every page by the calling thread
+	if (vector->data != NULL && vector->allocated != 0)
+	{
+		JC_Vector_Copy_Context context;
+		context.destination = temp_data;
+		context.source = vector->data;
+		context.type_size = vector->type_size;
+
+		JC_vector_numa_first_touch(capacity, 0, vector->allocated, vector->type_size, JC_vector_numa_copy_task, &context);
+	}
+
+	JC_vector_buffer_free(vector->data, vector->capacity * vector->type_size);
+	vector->data = temp_data;
+	vector->capacity = capacity;
+
+	// the charge above was for the whole pages, so the difference to what the vector ended up with is handed back
+	JC_vector_memory_settle(accounted, vector->capacity * vector->type_size);
+
+	return true;
+}
+
+
+static inline JC_Vector* JC_vector_construct_numa(size_t size, size_t type_size, const JC_Vector_NUMA_Policy policy, const uint64_t node_mask)
+{
+	JC_Vector* new_vector = JC_vector_construct(0, type_size);
+
+	if (new_vector == NULL)
+	{
+		return NULL;
+	}
+
+	if (size < JC_C_VECTOR_MIN_ELEMENTS)
+	{
+		size = JC_C_VECTOR_MIN_ELEMENTS;
+	}
+
+	if (!JC_vector_reserve_numa(new_vector, size, policy, node_mask))
+	{
+		JC_vector_destruct(&new_vector);
+		return NULL;
+	}
+
+	return new_vector;
+}
+
+
+
+
+
+
+// ---------------------------------------------------------------------------
+//							Parallel Initialization
+// ---------------------------------------------------------------------------
+
+static inline void JC_vector_fill_task(const size_t task_index, const size_t begin, const size_t end, void* const context_ptr)
+{
+	(void)task_index;
+
+	JC_Vector_Fill_Context* context = context_ptr;
+	JC_Vector* vector = context->vector;
+	char* destination = vector->data + begin * vector->type_size;
+
+	if (context->value == NULL)
+		memset(destination, 0, (end - begin) * vector->type_size);
+	else
+		vector->ops->fill(destination, context->value, end - begin, vector->type_size);
+}
+
+
+// Writes value into [start, end) split between threads with JC_vector_numa_first_touch(), so on a fresh buffer each page is
+// placed on the node JC_vector_numa_node_of() gives it. Threads which later read a range only get local memory if they run
+// on that node too, for example by calling JC_vector_numa_run_on_node() at the start of a JC_vector_parallel_for() task
+static inline void JC_vector_parallel_fill_range(JC_Vector* const restrict vector, const size_t start, const size_t end, const void* const restrict value)
+{
+	JC_Vector_Fill_Context context;
+	context.vector = vector;
+	context.value = value;
+
+	JC_vector_numa_first_touch(vector->capacity, start, end, vector->type_size, JC_vector_fill_task, &context);
+}
+
+
+// Sets every element to value, from several threads at once
+static inline void JC_vector_parallel_fill(JC_Vector* const restrict vector, const void* const restrict value)
+{
+	JC_vector_parallel_fill_range(vector, 0, vector->allocated, value);
+}
+
+
+// Same as JC_vector_resize_ptr(), except new elements are written by JC_vector_parallel_fill_range(), so their pages are spread
+// over the nodes instead of all landing on the calling thread's node. Growing goes through
+// JC_vector_reserve_numa() with the policy the current buffer was placed with, so it's kept. A NULL default_value fills with zeros
+static inline bool JC_vector_parallel_resize_ptr(JC_Vector* const restrict vector, const size_t new_size, const void* const restrict default_value)
+{
+	if (new_size <= vector->allocated)
+	{
+		vector->allocated = new_size;
+		return true;
+	}
+
+	if (new_size > vector->capacity)
+	{
+		size_t capacity = vector->capacity ? vector->capacity : JC_C_VECTOR_MIN_ELEMENTS;
+
+		while (capacity < new_size && capacity * JC_C_VECTOR_RESIZE_FACTOR * vector->type_size <= JC_C_VECTOR_MAX_SIZE)
+			capacity *= JC_C_VECTOR_RESIZE_FACTOR;
+
+		if (capacity < new_size)
+			capacity = new_size;
+
+		uint64_t node_mask;
+		JC_Vector_NUMA_Policy policy = JC_vector_numa_policy(vector->data, &node_mask);
+
+		if (!JC_vector_reserve_numa(vector, capacity, policy, node_mask))
+			return false;
+	}
+
+	JC_vector_parallel_fill_range(vector, vector->allocated, new_size, default_value);
+
+	vector->allocated = new_size;
+	return true;
+}
+
+
+static inline bool JC_vector_parallel_resize(JC_Vector* const restrict vector, const size_t new_size)
+{
+	return JC_vector_parallel_resize_ptr(vector, new_size, NULL);
+}
+
+
+#endif
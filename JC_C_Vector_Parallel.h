@@ -0,0 +1,399 @@
+#ifndef JC_C_VECTOR_PARALLEL_H_FILE
+#define JC_C_VECTOR_PARALLEL_H_FILE
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <threads.h>
+#include "JC_C_Vector.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+#define JC_C_VECTOR_PARALLEL_MAX_THREADS 64
+
+// Work smaller than this many bytes per thread isn't worth starting a thread for
+#define JC_C_VECTOR_PARALLEL_MIN_BYTES (1 << 16)
+
+// Range boundaries are placed on cache line boundaries, so two threads writing neighbouring ranges never share a line
+#define JC_C_VECTOR_PARALLEL_CACHE_LINE 64
+
+// How many bytes JC_vector_parallel_for() hands a worker at a time when no grain is given
+#define JC_C_VECTOR_PARALLEL_GRAIN_BYTES (1 << 14)
+
+
+
+
+// Called with a half open range of elements [begin, end) to process. JC_vector_parallel_run() calls it once per task, with
+// task_index in [0, task_count) and lower indices always getting lower ranges. JC_vector_parallel_for() calls it once per
+// chunk, with task_index being the index of the worker running that chunk, so the same index comes with many ranges in no order
+typedef void (*JC_Vector_Parallel_Task)(size_t task_index, size_t begin, size_t end, void* context);
+
+
+typedef struct JC_Vector_Parallel_Job
+{
+	JC_Vector_Parallel_Task task;
+	void* context;
+	size_t task_index;
+	size_t begin;
+	size_t end;
+}
+JC_Vector_Parallel_Job;
+
+
+// A half open range of element indices [begin, end)
+typedef struct JC_Vector_Range
+{
+	size_t begin;
+	size_t end;
+}
+JC_Vector_Range;
+
+
+// One per worker of JC_vector_parallel_for(). The owner takes chunks from the front of its range, and other workers which
+// have run out of work steal the back half of it. The padding keeps each worker's range on its own cache line
+typedef struct JC_Vector_Steal_Range
+{
+	atomic_flag lock;
+	JC_Vector_Range range;
+
+	char padding[JC_C_VECTOR_PARALLEL_CACHE_LINE];
+}
+JC_Vector_Steal_Range;
+
+
+typedef struct JC_Vector_Parallel_For
+{
+	const JC_Vector* vector;
+	size_t grain;
+	size_t workers;
+	JC_Vector_Parallel_Task task;
+	void* context;
+
+	JC_Vector_Steal_Range ranges[JC_C_VECTOR_PARALLEL_MAX_THREADS];
+}
+JC_Vector_Parallel_For;
+
+
+static size_t JC_vector_parallel_thread_limit = 0;
+
+
+
+
+
+
+// ---------------------------------------------------------------------------
+//								Thread Count
+// ---------------------------------------------------------------------------
+
+// 0 means use every online processor
+static inline void JC_vector_parallel_set_threads(size_t threads)
+{
+	if (threads > JC_C_VECTOR_PARALLEL_MAX_THREADS)
+		threads = JC_C_VECTOR_PARALLEL_MAX_THREADS;
+
+	JC_vector_parallel_thread_limit = threads;
+}
+
+
+static inline size_t JC_vector_parallel_threads(void)
+{
+	if (JC_vector_parallel_thread_limit != 0)
+		return JC_vector_parallel_thread_limit;
+
+	long processors = 1;
+
+#if defined(_SC_NPROCESSORS_ONLN)
+	processors = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+
+	if (processors < 1)
+		return 1;
+
+	return (size_t)processors < JC_C_VECTOR_PARALLEL_MAX_THREADS ? (size_t)processors : JC_C_VECTOR_PARALLEL_MAX_THREADS;
+}
+
+
+
+
+
+
+// ---------------------------------------------------------------------------
+//									Running
+// ---------------------------------------------------------------------------
+
+static inline int JC_vector_parallel_thread_main(void* argument)
+{
+	JC_Vector_Parallel_Job* job = argument;
+	job->task(job->task_index, job->begin, job->end, job->context);
+	return 0;
+}
+
+
+// How many tasks JC_vector_parallel_run() will split count elements into, with at least min_per_task elements each
+static inline size_t JC_vector_parallel_task_count(const size_t count, size_t min_per_task)
+{
+	if (min_per_task == 0)
+		min_per_task = 1;
+
+	size_t tasks = count / min_per_task;
+	size_t threads = JC_vector_parallel_threads();
+
+	if (tasks > threads)
+		tasks = threads;
+
+	return tasks == 0 ? 1 : tasks;
+}
+
+
+// Splits [0, count) into JC_vector_parallel_task_count() nearly equal ranges, runs all but the first on new threads and the
+// first on the calling thread, and returns once every task has finished. If a thread can't be started its task runs on the
+// calling thread instead, so every task always runs exactly once. Returns the amount of tasks
+static inline size_t JC_vector_parallel_run(const size_t count, const size_t min_per_task, const JC_Vector_Parallel_Task task, void* const context)
+{
+	size_t tasks = JC_vector_parallel_task_count(count, min_per_task);
+
+	JC_Vector_Parallel_Job jobs[JC_C_VECTOR_PARALLEL_MAX_THREADS];
+	thrd_t threads[JC_C_VECTOR_PARALLEL_MAX_THREADS];
+	bool started[JC_C_VECTOR_PARALLEL_MAX_THREADS];
+
+	for (size_t i = 0; i < tasks; i++)
+	{
+		jobs[i].task = task;
+		jobs[i].context = context;
+		jobs[i].task_index = i;
+		jobs[i].begin = count / tasks * i + (i < count % tasks ? i : count % tasks);
+		jobs[i].end = jobs[i].begin + count / tasks + (i < count % tasks);
+	}
+
+	for (size_t i = 1; i < tasks; i++)
+		started[i] = thrd_create(&threads[i], JC_vector_parallel_thread_main, &jobs[i]) == thrd_success;
+
+	JC_vector_parallel_thread_main(&jobs[0]);
+
+	for (size_t i = 1; i < tasks; i++)
+	{
+		if (started[i])
+			thrd_join(threads[i], NULL);
+		else
+			JC_vector_parallel_thread_main(&jobs[i]);
+	}
+
+	return tasks;
+}
+
+
+
+
+
+
+// ---------------------------------------------------------------------------
+//								Range Splitting
+// ---------------------------------------------------------------------------
+
+// Moves index to the nearest element which starts on a cache line boundary, judged by the element's actual address.
+// Exact when type_size divides JC_C_VECTOR_PARALLEL_CACHE_LINE, otherwise the element straddling the line goes to the later range
+static inline size_t JC_vector_align_split(const JC_Vector* const restrict vector, const size_t index)
+{
+	if (index >= vector->allocated)
+		return vector->allocated;
+
+	if (vector->type_size == 0)
+		return index;
+
+	uintptr_t start = (uintptr_t)vector->data;
+	uintptr_t address = start + index * vector->type_size;
+	uintptr_t aligned = (address + JC_C_VECTOR_PARALLEL_CACHE_LINE / 2) / JC_C_VECTOR_PARALLEL_CACHE_LINE * JC_C_VECTOR_PARALLEL_CACHE_LINE;
+
+	if (aligned <= start)
+		return 0;
+
+	size_t aligned_index = (aligned - start + vector->type_size - 1) / vector->type_size;
+
+	return aligned_index < vector->allocated ? aligned_index : vector->allocated;
+}
+
+
+// Splits the vector's elements into at most parts contiguous ranges of nearly equal size with cache line aligned boundaries,
+// writing them into ranges. Ranges which would be empty after alignment are left out. Returns the amount of ranges written
+static inline size_t JC_vector_split_count(const JC_Vector* const restrict vector, const size_t parts, JC_Vector_Range* const restrict ranges)
+{
+	const size_t count = vector->allocated;
+	size_t written = 0;
+	size_t begin = 0;
+
+	for (size_t i = 1; i <= parts && begin < count; i++)
+	{
+		size_t end = i == parts ? count : JC_vector_align_split(vector, count / parts * i + count % parts * i / parts);
+
+		if (end <= begin)
+			continue;
+
+		ranges[written].begin = begin;
+		ranges[written].end = end;
+		written++;
+
+		begin = end;
+	}
+
+	return written;
+}
+
+
+// Same as JC_vector_split_count(), with enough ranges that each holds about byte_budget bytes, up to max_ranges of them
+static inline size_t JC_vector_split_bytes(const JC_Vector* const restrict vector, size_t byte_budget, JC_Vector_Range* const restrict ranges, const size_t max_ranges)
+{
+	if (byte_budget == 0)
+		byte_budget = 1;
+
+	size_t bytes = vector->allocated * vector->type_size;
+	size_t parts = (bytes + byte_budget - 1) / byte_budget;
+
+	if (parts > max_ranges)
+		parts = max_ranges;
+	if (parts == 0)
+		parts = 1;
+
+	return JC_vector_split_count(vector, parts, ranges);
+}
+
+
+// Splits range at its cache line aligned middle, keeping the front half in range and writing the back half into back_half.
+// Returns false, leaving range alone, if there is no aligned boundary strictly inside it
+static inline bool JC_vector_range_halve(const JC_Vector* const restrict vector, JC_Vector_Range* const restrict range, JC_Vector_Range* const restrict back_half)
+{
+	if (range->end - range->begin < 2)
+		return false;
+
+	size_t middle = JC_vector_align_split(vector, range->begin + (range->end - range->begin) / 2);
+
+	if (middle <= range->begin || middle >= range->end)
+		return false;
+
+	back_half->begin = middle;
+	back_half->end = range->end;
+	range->end = middle;
+
+	return true;
+}
+
+
+
+
+
+
+// ---------------------------------------------------------------------------
+//								Work Stealing
+// ---------------------------------------------------------------------------
+
+static inline void JC_vector_steal_range_lock(JC_Vector_Steal_Range* const range)
+{
+	while (atomic_flag_test_and_set_explicit(&range->lock, memory_order_acquire))
+		;
+}
+
+static inline void JC_vector_steal_range_unlock(JC_Vector_Steal_Range* const range)
+{
+	atomic_flag_clear_explicit(&range->lock, memory_order_release);
+}
+
+
+// Takes up to one grain of elements from the front of the worker's own range, or if that is empty steals the back half
+// of another worker's range. Returns false once no worker has anything left that can be taken
+static inline bool JC_vector_parallel_for_take(JC_Vector_Parallel_For* const state, const size_t worker, JC_Vector_Range* const restrict chunk)
+{
+	JC_Vector_Steal_Range* own = &state->ranges[worker];
+
+	JC_vector_steal_range_lock(own);
+	if (own->range.begin < own->range.end)
+	{
+		// chunks don't need aligning, since only the owner works on either side of them. Ranges are only split between
+		// workers by JC_vector_range_halve(), which does align
+		size_t end = own->range.end - own->range.begin > state->grain ? own->range.begin + state->grain : own->range.end;
+
+		chunk->begin = own->range.begin;
+		chunk->end = end;
+		own->range.begin = end;
+
+		JC_vector_steal_range_unlock(own);
+		return true;
+	}
+	JC_vector_steal_range_unlock(own);
+
+	// victims are tried in order starting after this worker, so thieves spread out over different victims
+	for (size_t i = 1; i < state->workers; i++)
+	{
+		JC_Vector_Steal_Range* victim = &state->ranges[(worker + i) % state->workers];
+		JC_Vector_Range stolen;
+		bool found = false;
+
+		JC_vector_steal_range_lock(victim);
+		if (victim->range.end - victim->range.begin > state->grain)
+			found = JC_vector_range_halve(state->vector, &victim->range, &stolen);
+		JC_vector_steal_range_unlock(victim);
+
+		if (!found)
+			continue;
+
+		// the stolen half becomes this worker's own range, so others can steal from it in turn
+		JC_vector_steal_range_lock(own);
+		own->range = stolen;
+		JC_vector_steal_range_unlock(own);
+
+		return JC_vector_parallel_for_take(state, worker, chunk);
+	}
+
+	return false;
+}
+
+
+// Run as one task of JC_vector_parallel_run() per worker, so task_index is the worker's index
+static inline void JC_vector_parallel_for_worker(const size_t task_index, const size_t begin, const size_t end, void* const context)
+{
+	(void)begin;
+	(void)end;
+
+	JC_Vector_Parallel_For* state = context;
+	JC_Vector_Range chunk;
+
+	while (JC_vector_parallel_for_take(state, task_index, &chunk))
+		state->task(task_index, chunk.begin, chunk.end, state->context);
+}
+
+
+// Calls task(worker_index, begin, end, context) for chunks of up to grain elements until every element of the vector has been
+// handed out exactly once. worker_index is in [0, workers) and is the same for every chunk one worker runs, so it can index
+// per worker state, but chunks arrive in no particular order. Every worker starts with an equal share, and workers which run
+// out steal half of what another worker has left, so uneven work per element still keeps every thread busy. A grain of 0 uses
+// JC_C_VECTOR_PARALLEL_GRAIN_BYTES worth of elements. Returns the amount of workers used
+static inline size_t JC_vector_parallel_for(const JC_Vector* const restrict vector, size_t grain, const JC_Vector_Parallel_Task task, void* const context)
+{
+	if (grain == 0)
+		grain = vector->type_size ? (JC_C_VECTOR_PARALLEL_GRAIN_BYTES + vector->type_size - 1) / vector->type_size : vector->allocated;
+	if (grain == 0)
+		grain = 1;
+
+	JC_Vector_Parallel_For state;
+	state.vector = vector;
+	state.grain = grain;
+	state.task = task;
+	state.context = context;
+
+	JC_Vector_Range initial[JC_C_VECTOR_PARALLEL_MAX_THREADS];
+	state.workers = JC_vector_split_count(vector, JC_vector_parallel_task_count(vector->allocated, grain), initial);
+
+	for (size_t i = 0; i < state.workers; i++)
+	{
+		atomic_flag_clear(&state.ranges[i].lock);
+		state.ranges[i].range = initial[i];
+	}
+
+	if (state.workers != 0)
+		JC_vector_parallel_run(state.workers, 1, JC_vector_parallel_for_worker, &state);
+
+	return state.workers;
+}
+
+
+#endif
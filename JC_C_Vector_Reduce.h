@@ -0,0 +1,528 @@
+#ifndef JC_C_VECTOR_REDUCE_H_FILE
+#define JC_C_VECTOR_REDUCE_H_FILE
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "JC_C_Vector.h"
+#include "JC_C_Vector_Parallel.h"
+
+// Amount of independent accumulators used by the sum loops. Lets the compiler vectorize them,
+// and keeps floating point additions from all waiting on a single register
+#define JC_C_VECTOR_REDUCE_LANES 8
+
+// Reductions over fewer bytes than this stay on the calling thread. Starting and joining threads for every call costs
+// about as much as one thread streaming through this much memory, so splitting smaller vectors only makes them slower
+#define JC_C_VECTOR_REDUCE_SERIAL_BYTES (1 << 19)
+
+
+
+
+typedef enum JC_Vector_Numeric_Type
+{
+	JC_VECTOR_INT8,
+	JC_VECTOR_INT16,
+	JC_VECTOR_INT32,
+	JC_VECTOR_INT64,
+	JC_VECTOR_UINT8,
+	JC_VECTOR_UINT16,
+	JC_VECTOR_UINT32,
+	JC_VECTOR_UINT64,
+	JC_VECTOR_FLOAT,
+	JC_VECTOR_DOUBLE,
+	JC_VECTOR_NUMERIC_TYPES
+}
+JC_Vector_Numeric_Type;
+
+
+// Results are widened to the largest type of their kind. Signed types use i, unsigned types use u, and floating point types use d
+typedef union JC_Vector_Scalar
+{
+	int64_t i;
+	uint64_t u;
+	double d;
+}
+JC_Vector_Scalar;
+
+
+typedef struct JC_Vector_Min_Max
+{
+	JC_Vector_Scalar min;
+	JC_Vector_Scalar max;
+	size_t argmin;
+	size_t argmax;
+}
+JC_Vector_Min_Max;
+
+
+typedef enum JC_Vector_Scalar_Kind
+{
+	JC_VECTOR_SCALAR_SIGNED,
+	JC_VECTOR_SCALAR_UNSIGNED,
+	JC_VECTOR_SCALAR_FLOATING
+}
+JC_Vector_Scalar_Kind;
+
+
+
+
+
+
+// ---------------------------------------------------------------------------
+//								Kernels
+// ---------------------------------------------------------------------------
+
+// Defines the sum, min/max and histogram loops for one element type over the range [begin, end)
+#define JC_C_VECTOR_DEFINE_REDUCE_KERNELS(suffix, type, accumulator_type, field)																\
+static void JC_vector_sum_range_##suffix(const char* const data, const size_t begin, const size_t end, JC_Vector_Scalar* const result)		\
+{																																			\
+	const type* values = (const type*)data;																									\
+	accumulator_type lanes[JC_C_VECTOR_REDUCE_LANES] = { 0 };																				\
+	size_t i = begin;																														\
+																																			\
+	for (; i + JC_C_VECTOR_REDUCE_LANES <= end; i += JC_C_VECTOR_REDUCE_LANES)																\
+		for (size_t lane = 0; lane < JC_C_VECTOR_REDUCE_LANES; lane++)																		\
+			lanes[lane] += values[i + lane];																								\
+																																			\
+	for (; i < end; i++)																													\
+		lanes[0] += values[i];																												\
+																																			\
+	accumulator_type sum = 0;																												\
+	for (size_t lane = 0; lane < JC_C_VECTOR_REDUCE_LANES; lane++)																			\
+		sum += lanes[lane];																													\
+																																			\
+	result->field = sum;																													\
+}																																			\
+																																			\
+static void JC_vector_min_max_range_##suffix(const char* const data, const size_t begin, const size_t end, JC_Vector_Min_Max* const result)	\
+{																																			\
+	const type* values = (const type*)data;																									\
+	type mins[JC_C_VECTOR_REDUCE_LANES];																									\
+	type maxes[JC_C_VECTOR_REDUCE_LANES];																									\
+	size_t i = begin;																														\
+																																			\
+	for (size_t lane = 0; lane < JC_C_VECTOR_REDUCE_LANES; lane++)																			\
+		mins[lane] = maxes[lane] = values[begin];																							\
+																																			\
+	/* separate branchless min and max lanes, so the compiler can turn this loop into vector min and max instructions */					\
+	for (; i + JC_C_VECTOR_REDUCE_LANES <= end; i += JC_C_VECTOR_REDUCE_LANES)																\
+		for (size_t lane = 0; lane < JC_C_VECTOR_REDUCE_LANES; lane++)																		\
+		{																																	\
+			type value = values[i + lane];																									\
+			mins[lane] = value < mins[lane] ? value : mins[lane];																			\
+			maxes[lane] = value > maxes[lane] ? value : maxes[lane];																		\
+		}																																	\
+																																			\
+	type min = mins[0];																														\
+	type max = maxes[0];																													\
+	for (size_t lane = 1; lane < JC_C_VECTOR_REDUCE_LANES; lane++)																			\
+	{																																		\
+		min = mins[lane] < min ? mins[lane] : min;																							\
+		max = maxes[lane] > max ? maxes[lane] : max;																						\
+	}																																		\
+																																			\
+	for (; i < end; i++)																													\
+	{																																		\
+		min = values[i] < min ? values[i] : min;																							\
+		max = values[i] > max ? values[i] : max;																							\
+	}																																		\
+																																			\
+	/* the first index holding each is found afterwards, stopping as soon as both have been seen */											\
+	size_t argmin = end;																													\
+	size_t argmax = end;																													\
+																																			\
+	for (i = begin; i < end && (argmin == end || argmax == end); i++)																		\
+	{																																		\
+		if (argmin == end && values[i] == min) argmin = i;																					\
+		if (argmax == end && values[i] == max) argmax = i;																					\
+	}																																		\
+																																			\
+	result->min.field = min;																												\
+	result->max.field = max;																												\
+	result->argmin = argmin == end ? begin : argmin;																						\
+	result->argmax = argmax == end ? begin : argmax;																						\
+}																																			\
+																																			\
+static void JC_vector_histogram_range_##suffix(const char* const data, const size_t begin, const size_t end,								\
+	const double low, const double high, const size_t bins, size_t* const counts)															\
+{																																			\
+	const type* values = (const type*)data;																									\
+	const double scale = bins / (high - low);																								\
+																																			\
+	for (size_t i = begin; i < end; i++)																									\
+	{																																		\
+		double value = (double)values[i];																									\
+		if (value >= low && value < high)																									\
+		{																																	\
+			size_t bin = (size_t)((value - low) * scale);																					\
+			counts[bin < bins ? bin : bins - 1]++;																							\
+		}																																	\
+	}																																		\
+}
+
+// Signed sums are accumulated unsigned, so a sum that overflows wraps around like the vector lanes do instead of being undefined
+JC_C_VECTOR_DEFINE_REDUCE_KERNELS(int8, int8_t, uint64_t, i)
+JC_C_VECTOR_DEFINE_REDUCE_KERNELS(int16, int16_t, uint64_t, i)
+JC_C_VECTOR_DEFINE_REDUCE_KERNELS(int32, int32_t, uint64_t, i)
+JC_C_VECTOR_DEFINE_REDUCE_KERNELS(int64, int64_t, uint64_t, i)
+JC_C_VECTOR_DEFINE_REDUCE_KERNELS(uint8, uint8_t, uint64_t, u)
+JC_C_VECTOR_DEFINE_REDUCE_KERNELS(uint16, uint16_t, uint64_t, u)
+JC_C_VECTOR_DEFINE_REDUCE_KERNELS(uint32, uint32_t, uint64_t, u)
+JC_C_VECTOR_DEFINE_REDUCE_KERNELS(uint64, uint64_t, uint64_t, u)
+JC_C_VECTOR_DEFINE_REDUCE_KERNELS(float, float, double, d)
+JC_C_VECTOR_DEFINE_REDUCE_KERNELS(double, double, double, d)
+
+
+typedef struct JC_Vector_Numeric_Kernels
+{
+	size_t type_size;
+	JC_Vector_Scalar_Kind kind;
+	void (*sum)(const char*, size_t, size_t, JC_Vector_Scalar*);
+	void (*min_max)(const char*, size_t, size_t, JC_Vector_Min_Max*);
+	void (*histogram)(const char*, size_t, size_t, double, double, size_t, size_t*);
+}
+JC_Vector_Numeric_Kernels;
+
+
+static const JC_Vector_Numeric_Kernels JC_vector_numeric_kernels[JC_VECTOR_NUMERIC_TYPES] =
+{
+	{ sizeof(int8_t), JC_VECTOR_SCALAR_SIGNED, JC_vector_sum_range_int8, JC_vector_min_max_range_int8, JC_vector_histogram_range_int8 },
+	{ sizeof(int16_t), JC_VECTOR_SCALAR_SIGNED, JC_vector_sum_range_int16, JC_vector_min_max_range_int16, JC_vector_histogram_range_int16 },
+	{ sizeof(int32_t), JC_VECTOR_SCALAR_SIGNED, JC_vector_sum_range_int32, JC_vector_min_max_range_int32, JC_vector_histogram_range_int32 },
+	{ sizeof(int64_t), JC_VECTOR_SCALAR_SIGNED, JC_vector_sum_range_int64, JC_vector_min_max_range_int64, JC_vector_histogram_range_int64 },
+	{ sizeof(uint8_t), JC_VECTOR_SCALAR_UNSIGNED, JC_vector_sum_range_uint8, JC_vector_min_max_range_uint8, JC_vector_histogram_range_uint8 },
+	{ sizeof(uint16_t), JC_VECTOR_SCALAR_UNSIGNED, JC_vector_sum_range_uint16, JC_vector_min_max_range_uint16, JC_vector_histogram_range_uint16 },
+	{ sizeof(uint32_t), JC_VECTOR_SCALAR_UNSIGNED, JC_vector_sum_range_uint32, JC_vector_min_max_range_uint32, JC_vector_histogram_range_uint32 },
+	{ sizeof(uint64_t), JC_VECTOR_SCALAR_UNSIGNED, JC_vector_sum_range_uint64, JC_vector_min_max_range_uint64, JC_vector_histogram_range_uint64 },
+	{ sizeof(float), JC_VECTOR_SCALAR_FLOATING, JC_vector_sum_range_float, JC_vector_min_max_range_float, JC_vector_histogram_range_float },
+	{ sizeof(double), JC_VECTOR_SCALAR_FLOATING, JC_vector_sum_range_double, JC_vector_min_max_range_double, JC_vector_histogram_range_double },
+};
+
+
+static inline bool JC_vector_numeric_type_matches(const JC_Vector* const restrict vector, const JC_Vector_Numeric_Type type)
+{
+	return (unsigned)type < JC_VECTOR_NUMERIC_TYPES && JC_vector_numeric_kernels[type].type_size == vector->type_size;
+}
+
+
+static inline bool JC_vector_scalar_less(const JC_Vector_Scalar_Kind kind, const JC_Vector_Scalar a, const JC_Vector_Scalar b)
+{
+	switch (kind)
+	{
+	case JC_VECTOR_SCALAR_SIGNED:
+		return a.i < b.i;
+	case JC_VECTOR_SCALAR_UNSIGNED:
+		return a.u < b.u;
+	default:
+		return a.d < b.d;
+	}
+}
+
+
+
+
+
+
+// ---------------------------------------------------------------------------
+//							Parallel Tasks
+// ---------------------------------------------------------------------------
+
+// Each task writes only its own entry of partials, which are combined on the calling thread afterwards
+typedef struct JC_Vector_Reduce_Context
+{
+	const JC_Vector* vector;
+	const JC_Vector_Numeric_Kernels* kernels;
+
+	JC_Vector_Scalar sums[JC_C_VECTOR_PARALLEL_MAX_THREADS];
+	JC_Vector_Min_Max min_maxes[JC_C_VECTOR_PARALLEL_MAX_THREADS];
+
+	double low;
+	double high;
+	size_t bins;
+	size_t* counts;
+
+	const void* value;
+	size_t matches[JC_C_VECTOR_PARALLEL_MAX_THREADS];
+
+	const void* identity;
+	void (*reducer)(void*, const void*);
+	char* accumulators;
+}
+JC_Vector_Reduce_Context;
+
+
+static inline void JC_vector_sum_task(size_t task_index, size_t begin, size_t end, void* context)
+{
+	JC_Vector_Reduce_Context* reduce = context;
+	reduce->kernels->sum(reduce->vector->data, begin, end, &reduce->sums[task_index]);
+}
+
+static inline void JC_vector_min_max_task(size_t task_index, size_t begin, size_t end, void* context)
+{
+	JC_Vector_Reduce_Context* reduce = context;
+	reduce->kernels->min_max(reduce->vector->data, begin, end, &reduce->min_maxes[task_index]);
+}
+
+static inline void JC_vector_histogram_task(size_t task_index, size_t begin, size_t end, void* context)
+{
+	JC_Vector_Reduce_Context* reduce = context;
+	reduce->kernels->histogram(reduce->vector->data, begin, end, reduce->low, reduce->high, reduce->bins, reduce->counts + task_index * reduce->bins);
+}
+
+static inline void JC_vector_count_task(size_t task_index, size_t begin, size_t end, void* context)
+{
+	JC_Vector_Reduce_Context* reduce = context;
+	size_t type_size = reduce->vector->type_size;
+	size_t matches = 0;
+
+	for (size_t i = begin; i < end; i++)
+		matches += memcmp(reduce->vector->data + i * type_size, reduce->value, type_size) == 0;
+
+	reduce->matches[task_index] = matches;
+}
+
+static inline void JC_vector_reduce_task(size_t task_index, size_t begin, size_t end, void* context)
+{
+	JC_Vector_Reduce_Context* reduce = context;
+	size_t type_size = reduce->vector->type_size;
+	char* accumulator = reduce->accumulators + task_index * type_size;
+
+	memcpy(accumulator, reduce->identity, type_size);
+
+	for (size_t i = begin; i < end; i++)
+		reduce->reducer(accumulator, reduce->vector->data + i * type_size);
+}
+
+
+// Vectors under JC_C_VECTOR_REDUCE_SERIAL_BYTES are given to a single task, which runs on the calling thread
+static inline size_t JC_vector_reduce_min_per_task(const JC_Vector* const restrict vector)
+{
+	if (vector->allocated * vector->type_size < JC_C_VECTOR_REDUCE_SERIAL_BYTES)
+		return vector->allocated;
+
+	return vector->type_size ? JC_C_VECTOR_PARALLEL_MIN_BYTES / vector->type_size : vector->allocated;
+}
+
+
+
+
+
+
+// ---------------------------------------------------------------------------
+//								Reductions
+// ---------------------------------------------------------------------------
+
+static inline bool JC_vector_sum(const JC_Vector* const restrict vector, const JC_Vector_Numeric_Type type, JC_Vector_Scalar* const restrict result)
+{
+	if (!JC_vector_numeric_type_matches(vector, type))
+		return false;
+
+	JC_Vector_Reduce_Context context;
+	context.vector = vector;
+	context.kernels = &JC_vector_numeric_kernels[type];
+
+	size_t tasks = JC_vector_parallel_run(vector->allocated, JC_vector_reduce_min_per_task(vector), JC_vector_sum_task, &context);
+
+	*result = context.sums[0];
+
+	for (size_t i = 1; i < tasks; i++)
+	{
+		switch (context.kernels->kind)
+		{
+		case JC_VECTOR_SCALAR_SIGNED:
+			result->i = (int64_t)((uint64_t)result->i + (uint64_t)context.sums[i].i);
+			break;
+		case JC_VECTOR_SCALAR_UNSIGNED:
+			result->u += context.sums[i].u;
+			break;
+		default:
+			result->d += context.sums[i].d;
+			break;
+		}
+	}
+
+	return true;
+}
+
+
+static inline bool JC_vector_min_max(const JC_Vector* const restrict vector, const JC_Vector_Numeric_Type type, JC_Vector_Min_Max* const restrict result)
+{
+	if (!JC_vector_numeric_type_matches(vector, type) || vector->allocated == 0)
+		return false;
+
+	JC_Vector_Reduce_Context context;
+	context.vector = vector;
+	context.kernels = &JC_vector_numeric_kernels[type];
+
+	size_t tasks = JC_vector_parallel_run(vector->allocated, JC_vector_reduce_min_per_task(vector), JC_vector_min_max_task, &context);
+
+	// the partials are in index order, so keeping the earlier one on ties gives the first index of the min and max
+	*result = context.min_maxes[0];
+
+	for (size_t i = 1; i < tasks; i++)
+	{
+		if (JC_vector_scalar_less(context.kernels->kind, context.min_maxes[i].min, result->min))
+		{
+			result->min = context.min_maxes[i].min;
+			result->argmin = context.min_maxes[i].argmin;
+		}
+
+		if (JC_vector_scalar_less(context.kernels->kind, result->max, context.min_maxes[i].max))
+		{
+			result->max = context.min_maxes[i].max;
+			result->argmax = context.min_maxes[i].argmax;
+		}
+	}
+
+	return true;
+}
+
+
+static inline bool JC_vector_min(const JC_Vector* const restrict vector, const JC_Vector_Numeric_Type type, JC_Vector_Scalar* const restrict result)
+{
+	JC_Vector_Min_Max min_max;
+
+	if (!JC_vector_min_max(vector, type, &min_max))
+		return false;
+
+	*result = min_max.min;
+	return true;
+}
+
+
+static inline bool JC_vector_max(const JC_Vector* const restrict vector, const JC_Vector_Numeric_Type type, JC_Vector_Scalar* const restrict result)
+{
+	JC_Vector_Min_Max min_max;
+
+	if (!JC_vector_min_max(vector, type, &min_max))
+		return false;
+
+	*result = min_max.max;
+	return true;
+}
+
+
+static inline bool JC_vector_argmin(const JC_Vector* const restrict vector, const JC_Vector_Numeric_Type type, size_t* const restrict index)
+{
+	JC_Vector_Min_Max min_max;
+
+	if (!JC_vector_min_max(vector, type, &min_max))
+		return false;
+
+	*index = min_max.argmin;
+	return true;
+}
+
+
+static inline bool JC_vector_argmax(const JC_Vector* const restrict vector, const JC_Vector_Numeric_Type type, size_t* const restrict index)
+{
+	JC_Vector_Min_Max min_max;
+
+	if (!JC_vector_min_max(vector, type, &min_max))
+		return false;
+
+	*index = min_max.argmax;
+	return true;
+}
+
+
+static inline bool JC_vector_mean(const JC_Vector* const restrict vector, const JC_Vector_Numeric_Type type, double* const restrict result)
+{
+	JC_Vector_Scalar sum;
+
+	if (vector->allocated == 0 || !JC_vector_sum(vector, type, &sum))
+		return false;
+
+	switch (JC_vector_numeric_kernels[type].kind)
+	{
+	case JC_VECTOR_SCALAR_SIGNED:
+		*result = (double)sum.i / vector->allocated;
+		break;
+	case JC_VECTOR_SCALAR_UNSIGNED:
+		*result = (double)sum.u / vector->allocated;
+		break;
+	default:
+		*result = sum.d / vector->allocated;
+		break;
+	}
+
+	return true;
+}
+
+
+static inline bool JC_vector_histogram(const JC_Vector* const restrict vector, const JC_Vector_Numeric_Type type, const double low, const double high, const size_t bins, size_t* const restrict counts)
+{
+	if (!JC_vector_numeric_type_matches(vector, type) || bins == 0 || !(low < high))
+		return false;
+
+	JC_Vector_Reduce_Context context;
+	context.vector = vector;
+	context.kernels = &JC_vector_numeric_kernels[type];
+	context.low = low;
+	context.high = high;
+	context.bins = bins;
+
+	// every task gets its own set of bins so that no two threads ever increment the same counter
+	size_t tasks = JC_vector_parallel_task_count(vector->allocated, JC_vector_reduce_min_per_task(vector));
+	context.counts = calloc(tasks * bins, sizeof(size_t));
+
+	if (context.counts == NULL)
+		return false;
+
+	JC_vector_parallel_run(vector->allocated, JC_vector_reduce_min_per_task(vector), JC_vector_histogram_task, &context);
+
+	memset(counts, 0, bins * sizeof(size_t));
+
+	for (size_t task = 0; task < tasks; task++)
+		for (size_t bin = 0; bin < bins; bin++)
+			counts[bin] += context.counts[task * bins + bin];
+
+	free(context.counts);
+	return true;
+}
+
+
+static inline size_t JC_vector_count(const JC_Vector* const restrict vector, const void* const restrict value)
+{
+	JC_Vector_Reduce_Context context;
+	context.vector = vector;
+	context.value = value;
+
+	size_t tasks = JC_vector_parallel_run(vector->allocated, JC_vector_reduce_min_per_task(vector), JC_vector_count_task, &context);
+	size_t matches = 0;
+
+	for (size_t i = 0; i < tasks; i++)
+		matches += context.matches[i];
+
+	return matches;
+}
+
+
+// reducer must be associative, since each thread reduces its own range starting from identity and the partial results are
+// then reduced together in order. It is called as reducer(accumulator, element) and must fold element into accumulator
+static inline bool JC_vector_reduce(const JC_Vector* const restrict vector, const void* const restrict identity, void reducer(void*, const void*), void* const restrict result)
+{
+	JC_Vector_Reduce_Context context;
+	context.vector = vector;
+	context.identity = identity;
+	context.reducer = reducer;
+
+	size_t tasks = JC_vector_parallel_task_count(vector->allocated, JC_vector_reduce_min_per_task(vector));
+	context.accumulators = malloc(tasks * vector->type_size + 1);
+
+	if (context.accumulators == NULL)
+		return false;
+
+	JC_vector_parallel_run(vector->allocated, JC_vector_reduce_min_per_task(vector), JC_vector_reduce_task, &context);
+
+	memcpy(result, identity, vector->type_size);
+
+	for (size_t i = 0; i < tasks; i++)
+		reducer(result, context.accumulators + i * vector->type_size);
+
+	free(context.accumulators);
+	return true;
+}
+
+
+#endif
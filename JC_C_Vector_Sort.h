@@ -0,0 +1,297 @@
+#ifndef JC_C_VECTOR_SORT_H_FILE
+#define JC_C_VECTOR_SORT_H_FILE
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "JC_C_Vector.h"
+
+#define JC_C_VECTOR_SORT_RADIX_BITS 8
+#define JC_C_VECTOR_SORT_RADIX (1 << JC_C_VECTOR_SORT_RADIX_BITS)
+
+// Ranges this small are finished with an insertion sort instead of another radix pass
+#define JC_C_VECTOR_SORT_INSERTION_THRESHOLD 32
+
+
+
+
+typedef enum JC_Vector_Key_Type
+{
+	JC_VECTOR_KEY_UNSIGNED,
+	JC_VECTOR_KEY_SIGNED,
+	JC_VECTOR_KEY_FLOAT
+}
+JC_Vector_Key_Type;
+
+
+// Where the key sits within each element, and how to read it
+typedef struct JC_Vector_Sort_Key
+{
+	size_t offset;
+	size_t size;
+	JC_Vector_Key_Type type;
+}
+JC_Vector_Sort_Key;
+
+
+
+
+
+
+// ---------------------------------------------------------------------------
+//								Keys
+// ---------------------------------------------------------------------------
+
+static inline bool JC_vector_sort_key_valid(const JC_Vector* const restrict vector, const JC_Vector_Sort_Key key)
+{
+	if (key.size != 1 && key.size != 2 && key.size != 4 && key.size != 8)
+		return false;
+
+	if (key.type == JC_VECTOR_KEY_FLOAT && key.size != sizeof(float) && key.size != sizeof(double))
+		return false;
+
+	return key.offset + key.size <= vector->type_size;
+}
+
+
+// Reads the key of element and maps it onto an unsigned integer which sorts in the same order. Signed keys have their sign bit
+// flipped so negatives come first. Negative floats have every bit flipped, since a larger magnitude means a smaller value,
+// and positive floats only have their sign bit flipped. This puts -0 right before +0, and NaNs at either end
+static inline uint64_t JC_vector_sort_key_bits(const char* const restrict element, const JC_Vector_Sort_Key key)
+{
+	uint64_t bits;
+
+	switch (key.size)
+	{
+	case 1: { uint8_t value; memcpy(&value, element + key.offset, 1); bits = value; break; }
+	case 2: { uint16_t value; memcpy(&value, element + key.offset, 2); bits = value; break; }
+	case 4: { uint32_t value; memcpy(&value, element + key.offset, 4); bits = value; break; }
+	default: { uint64_t value; memcpy(&value, element + key.offset, 8); bits = value; break; }
+	}
+
+	if (key.type == JC_VECTOR_KEY_UNSIGNED)
+		return bits;
+
+	uint64_t sign_bit = (uint64_t)1 << (key.size * 8 - 1);
+
+	if (key.type == JC_VECTOR_KEY_FLOAT && (bits & sign_bit))
+		return ~bits & (sign_bit | (sign_bit - 1));
+
+	return bits ^ sign_bit;
+}
+
+
+static inline size_t JC_vector_sort_digit(const char* const restrict element, const JC_Vector_Sort_Key key, const size_t digit)
+{
+	return (size_t)(JC_vector_sort_key_bits(element, key) >> (digit * JC_C_VECTOR_SORT_RADIX_BITS)) & (JC_C_VECTOR_SORT_RADIX - 1);
+}
+
+
+
+
+
+
+// ---------------------------------------------------------------------------
+//								Sorting
+// ---------------------------------------------------------------------------
+
+// Stable. temp must hold one element
+static inline void JC_vector_insertion_sort_range(char* const data, const size_t count, const size_t type_size, const JC_Vector_Sort_Key key, char* const temp)
+{
+	for (size_t i = 1; i < count; i++)
+	{
+		uint64_t bits = JC_vector_sort_key_bits(data + i * type_size, key);
+		size_t j = i;
+
+		while (j > 0 && JC_vector_sort_key_bits(data + (j - 1) * type_size, key) > bits)
+			j--;
+
+		if (j == i)
+			continue;
+
+		memcpy(temp, data + i * type_size, type_size);
+		memmove(data + (j + 1) * type_size, data + j * type_size, (i - j) * type_size);
+		memcpy(data + j * type_size, temp, type_size);
+	}
+}
+
+
+// American flag sort on one digit of [data, data + count), then recursion into each bucket on the next lower digit.
+// Elements are swapped into their buckets in place, so the only extra memory is the temp element and the bucket counts
+static inline void JC_vector_msd_sort_range(char* const data, const size_t count, const size_t type_size, const JC_Vector_Sort_Key key, const size_t digit, char* const temp)
+{
+	if (count <= JC_C_VECTOR_SORT_INSERTION_THRESHOLD)
+	{
+		JC_vector_insertion_sort_range(data, count, type_size, key, temp);
+		return;
+	}
+
+	size_t counts[JC_C_VECTOR_SORT_RADIX] = { 0 };
+	size_t next[JC_C_VECTOR_SORT_RADIX];
+	size_t ends[JC_C_VECTOR_SORT_RADIX];
+
+	for (size_t i = 0; i < count; i++)
+		counts[JC_vector_sort_digit(data + i * type_size, key, digit)]++;
+
+	size_t position = 0;
+
+	for (size_t bucket = 0; bucket < JC_C_VECTOR_SORT_RADIX; bucket++)
+	{
+		next[bucket] = position;
+		position += counts[bucket];
+		ends[bucket] = position;
+	}
+
+	// every element out of place is swapped straight into the next free spot of its own bucket
+	for (size_t bucket = 0; bucket < JC_C_VECTOR_SORT_RADIX; bucket++)
+	{
+		while (next[bucket] < ends[bucket])
+		{
+			char* element = data + next[bucket] * type_size;
+			size_t element_bucket = JC_vector_sort_digit(element, key, digit);
+
+			if (element_bucket == bucket)
+			{
+				next[bucket]++;
+				continue;
+			}
+
+			char* destination = data + next[element_bucket] * type_size;
+			next[element_bucket]++;
+
+			memcpy(temp, destination, type_size);
+			memcpy(destination, element, type_size);
+			memcpy(element, temp, type_size);
+		}
+	}
+
+	if (digit == 0)
+		return;
+
+	size_t start = 0;
+
+	for (size_t bucket = 0; bucket < JC_C_VECTOR_SORT_RADIX; bucket++)
+	{
+		if (counts[bucket] > 1)
+			JC_vector_msd_sort_range(data + start * type_size, counts[bucket], type_size, key, digit - 1, temp);
+
+		start += counts[bucket];
+	}
+}
+
+
+// Least significant digit first, scattering between data and scratch once per digit. All digit counts are taken in one pass
+// up front, and digits which are the same for every element are skipped. scratch must hold count elements
+static inline void JC_vector_lsd_sort_range(JC_Vector* const restrict vector, char* const scratch, const JC_Vector_Sort_Key key)
+{
+	const size_t count = vector->allocated;
+	const size_t type_size = vector->type_size;
+
+	size_t counts[sizeof(uint64_t)][JC_C_VECTOR_SORT_RADIX];
+	memset(counts, 0, sizeof(counts));
+
+	for (size_t i = 0; i < count; i++)
+	{
+		uint64_t bits = JC_vector_sort_key_bits(vector->data + i * type_size, key);
+
+		for (size_t digit = 0; digit < key.size; digit++)
+			counts[digit][(bits >> (digit * JC_C_VECTOR_SORT_RADIX_BITS)) & (JC_C_VECTOR_SORT_RADIX - 1)]++;
+	}
+
+	char* source = vector->data;
+	char* destination = scratch;
+
+	for (size_t digit = 0; digit < key.size; digit++)
+	{
+		size_t offsets[JC_C_VECTOR_SORT_RADIX];
+		size_t position = 0;
+		bool one_bucket = false;
+
+		for (size_t bucket = 0; bucket < JC_C_VECTOR_SORT_RADIX; bucket++)
+		{
+			one_bucket |= counts[digit][bucket] == count;
+			offsets[bucket] = position;
+			position += counts[digit][bucket];
+		}
+
+		if (one_bucket)
+			continue;
+
+		for (size_t i = 0; i < count; i++)
+		{
+			const char* element = source + i * type_size;
+			size_t bucket = JC_vector_sort_digit(element, key, digit);
+
+			vector->ops->copy(destination + offsets[bucket] * type_size, element, type_size);
+			offsets[bucket]++;
+		}
+
+		char* temp_ptr = source;
+		source = destination;
+		destination = temp_ptr;
+	}
+
+	// an odd amount of passes leaves the sorted elements in scratch
+	if (source != vector->data)
+		memcpy(vector->data, source, count * type_size);
+}
+
+
+// Sorts without any buffer the size of the vector, at the cost of not being stable.
+// Returns false if the key doesn't fit within the element, or isn't a supported size for its type
+static inline bool JC_vector_radix_sort_in_place(JC_Vector* const restrict vector, const size_t key_offset, const size_t key_size, const JC_Vector_Key_Type key_type)
+{
+	JC_Vector_Sort_Key key = { key_offset, key_size, key_type };
+
+	if (!JC_vector_sort_key_valid(vector, key))
+		return false;
+
+	char* temp = malloc(vector->type_size);
+
+	if (temp == NULL)
+		return false;
+
+	JC_vector_msd_sort_range(vector->data, vector->allocated, vector->type_size, key, key.size - 1, temp);
+
+	free(temp);
+	return true;
+}
+
+
+// Stable sort by key, using a scratch buffer the size of the vector. Returns false if the scratch buffer can't be allocated,
+// leaving the vector unchanged, or if the key doesn't fit within the element or isn't a supported size for its type.
+// JC_vector_radix_sort_in_place() can be used as the fallback when stability isn't needed
+static inline bool JC_vector_radix_sort(JC_Vector* const restrict vector, const size_t key_offset, const size_t key_size, const JC_Vector_Key_Type key_type)
+{
+	JC_Vector_Sort_Key key = { key_offset, key_size, key_type };
+
+	if (!JC_vector_sort_key_valid(vector, key))
+		return false;
+
+	if (vector->allocated <= JC_C_VECTOR_SORT_INSERTION_THRESHOLD)
+	{
+		char* temp = malloc(vector->type_size);
+
+		if (temp == NULL)
+			return false;
+
+		JC_vector_insertion_sort_range(vector->data, vector->allocated, vector->type_size, key, temp);
+
+		free(temp);
+		return true;
+	}
+
+	size_t usable;
+	char* scratch = JC_vector_buffer_alloc(vector->allocated * vector->type_size, &usable);
+
+	if (scratch == NULL)
+		return false;
+
+	JC_vector_lsd_sort_range(vector, scratch, key);
+
+	JC_vector_buffer_free(scratch, vector->allocated * vector->type_size);
+	return true;
+}
+
+
+#endif
@@ -1,6 +1,18 @@
 #include <stdio.h>
 #include "JC_C_Vector.h"
+#include "JC_C_Bit_Vector.h"
+#include "JC_C_Compressed_Vector.h"
+#include "JC_C_Channel.h"
+#include "JC_C_Persistent_Vector.h"
+#include "JC_C_Vector_Reduce.h"
+#include "JC_C_Slot_Map.h"
+#include "JC_C_Tombstone_Vector.h"
+#include "JC_C_Vector_NUMA.h"
+#include "JC_C_Vector_Sort.h"
+#include "JC_C_Sparse_Vector.h"
 #include <assert.h>
+#include <threads.h>
+#include <stddef.h>
 
 #define INITIALIZE_TEST_NUM 42
 
@@ -523,6 +535,22 @@ bool resize_test()
 		JC_vector_destruct(&vec);
 	}
 
+	// growing again after shrinking zeros the elements that were dropped
+	{
+		JC_Vector* vec = JC_vector_construct(20, sizeof(int));
+
+		for (int i = 1; i <= 20; i++)
+			JC_vector_pushback_ptr(vec, &i);
+
+		JC_vector_resize(vec, 5);
+		JC_vector_resize(vec, 20);
+
+		for (int i = 5; i < 20; i++)
+			assert(*(int*)JC_vector_at_ptr(vec, i) == 0);
+
+		JC_vector_destruct(&vec);
+	}
+
 	// test resizing with -99 as the new value
 	{
 		JC_Vector* vec = JC_vector_construct(20, sizeof(int));
@@ -552,27 +580,1699 @@ bool resize_test()
 
 		JC_vector_destruct(&vec);
 	}
+
+	return true;
 }
 
 
+bool bit_vector_test()
+{
+	// pushback, get, set and pop_back across several words
+	{
+		JC_Bit_Vector* vec = JC_bit_vector_construct(0);
+		assert(vec->capacity == JC_C_BIT_VECTOR_MIN_BITS);
+		assert(JC_bit_vector_empty(vec));
+
+		for (int i = 0; i < 300; i++)
+			assert(JC_bit_vector_pushback(vec, i % 3 == 0));
 
+		assert(vec->allocated == 300);
+		assert(vec->capacity >= 300);
+		assert(JC_bit_vector_popcount(vec) == 100);
 
+		for (int i = 0; i < 300; i++)
+			assert(JC_bit_vector_get(vec, i) == (i % 3 == 0));
 
+		assert(JC_bit_vector_set(vec, 1, true));
+		assert(JC_bit_vector_get(vec, 1));
+		assert(JC_bit_vector_set(vec, 1, false));
+		assert(!JC_bit_vector_get(vec, 1));
 
-int main() {
-	
-	assert(JC_vector_max_size() == JC_C_VECTOR_MAX_SIZE);
+		// out of bounds access fails rather than touching the bits past allocated
+		assert(!JC_bit_vector_set(vec, 300, true));
+		assert(!JC_bit_vector_get(vec, 300));
 
-	// Tests for the first implementation. Type independant via pointers, and no object oriented support
-	assert(construct_test());
-	assert(push_and_pop_test());
-	assert(grow_and_shrink_test());
-	assert(insert_test());
-	assert(erase_test());
-	assert(erase_if_test());
-	assert(are_same_test());
-	assert(swap_test());
-	assert(resize_test());
+		for (int i = 299; i >= 0; i--)
+		{
+			assert(JC_bit_vector_get(vec, i) == (i % 3 == 0));
+			JC_bit_vector_pop_back(vec);
+		}
+
+		assert(JC_bit_vector_empty(vec));
+		assert(JC_bit_vector_popcount(vec) == 0);
+
+		JC_bit_vector_destruct(&vec);
+		assert(vec == NULL);
+	}
+
+	// insert and erase carry bits across word boundaries
+	{
+		JC_Bit_Vector* vec = JC_bit_vector_construct(64);
+
+		for (int i = 0; i < 200; i++)
+			JC_bit_vector_pushback(vec, i % 2 == 0);
+
+		assert(JC_bit_vector_insert(vec, 0, true));
+		assert(JC_bit_vector_insert(vec, 100, true));
+		assert(JC_bit_vector_insert(vec, vec->allocated, true));
+		assert(!JC_bit_vector_insert(vec, vec->allocated + 1, true));
+		assert(vec->allocated == 203);
+
+		assert(JC_bit_vector_get(vec, 0));
+		assert(JC_bit_vector_get(vec, 100));
+		assert(JC_bit_vector_get(vec, 202));
+
+		for (int i = 1; i < 100; i++)
+			assert(JC_bit_vector_get(vec, i) == ((i - 1) % 2 == 0));
+
+		for (int i = 101; i < 202; i++)
+			assert(JC_bit_vector_get(vec, i) == ((i - 2) % 2 == 0));
+
+		assert(JC_bit_vector_erase(vec, 202));
+		assert(JC_bit_vector_erase(vec, 100));
+		assert(JC_bit_vector_erase(vec, 0));
+		assert(!JC_bit_vector_erase(vec, vec->allocated));
+		assert(vec->allocated == 200);
+
+		for (int i = 0; i < 200; i++)
+			assert(JC_bit_vector_get(vec, i) == (i % 2 == 0));
+
+		assert(JC_bit_vector_popcount(vec) == 100);
+
+		JC_bit_vector_destruct(&vec);
+	}
+
+	// find first set, resize and the word-wide operations
+	{
+		JC_Bit_Vector* vec1 = JC_bit_vector_construct(0);
+		JC_Bit_Vector* vec2 = JC_bit_vector_construct(0);
+
+		assert(JC_bit_vector_resize(vec1, 150, false));
+		assert(JC_bit_vector_resize(vec2, 150, true));
+		assert(JC_bit_vector_popcount(vec1) == 0);
+		assert(JC_bit_vector_popcount(vec2) == 150);
+
+		assert(JC_bit_vector_find_first_set(vec1) == vec1->allocated);
+		JC_bit_vector_set(vec1, 130, true);
+		JC_bit_vector_set(vec1, 70, true);
+		assert(JC_bit_vector_find_first_set(vec1) == 70);
+		assert(JC_bit_vector_find_next_set(vec1, 71) == 130);
+		assert(JC_bit_vector_find_next_set(vec1, 131) == vec1->allocated);
+
+		assert(JC_bit_vector_and(vec2, vec1));
+		assert(JC_bit_vector_popcount(vec2) == 2);
+
+		JC_bit_vector_not(vec2);
+		assert(JC_bit_vector_popcount(vec2) == 148);
+		assert(!JC_bit_vector_get(vec2, 70));
+		assert(JC_bit_vector_find_next_clear(vec2, 0) == 70);
+		assert(JC_bit_vector_find_next_clear(vec2, 71) == 130);
+		assert(JC_bit_vector_find_next_clear(vec2, 131) == vec2->allocated);
+
+		assert(JC_bit_vector_or(vec2, vec1));
+		assert(JC_bit_vector_popcount(vec2) == 150);
+
+		// shrinking clears the dropped bits so they don't reappear when growing again
+		assert(JC_bit_vector_resize(vec2, 10, false));
+		assert(JC_bit_vector_popcount(vec2) == 10);
+		assert(JC_bit_vector_resize(vec2, 150, false));
+		assert(JC_bit_vector_popcount(vec2) == 10);
+
+		assert(JC_bit_vector_pushback(vec1, true));
+		assert(!JC_bit_vector_and(vec1, vec2));
+
+		JC_bit_vector_destruct(&vec1);
+		JC_bit_vector_destruct(&vec2);
+	}
+
+	// tens of millions of flags are well within the bit vector's own limit
+	{
+		JC_Bit_Vector* vec1 = JC_bit_vector_construct(20000000);
+		assert(vec1 != NULL);
+		assert(JC_bit_vector_resize(vec1, 20000000, true));
+		assert(JC_bit_vector_popcount(vec1) == 20000000);
+
+		JC_Bit_Vector* vec2 = JC_bit_vector_construct(0);
+		assert(JC_bit_vector_resize(vec2, 30000000, false));
+		assert(JC_bit_vector_set(vec2, 29999999, true));
+		assert(JC_bit_vector_find_first_set(vec2) == 29999999);
+
+		assert(JC_bit_vector_construct(JC_C_BIT_VECTOR_MAX_BITS + 1) == NULL);
+
+		// sizes near SIZE_MAX would wrap when rounded up to words
+		assert(JC_bit_vector_construct(SIZE_MAX) == NULL);
+		assert(JC_bit_vector_construct(SIZE_MAX - 10) == NULL);
+		assert(!JC_bit_vector_reserve(vec2, SIZE_MAX));
+		assert(!JC_bit_vector_reserve(vec2, JC_C_BIT_VECTOR_MAX_BITS + 1));
+		assert(!JC_bit_vector_resize(vec2, SIZE_MAX, false));
+		assert(JC_bit_vector_size(vec2) == 30000000);
+
+		JC_bit_vector_destruct(&vec1);
+		JC_bit_vector_destruct(&vec2);
+	}
+
+	return true;
+}
+
+
+
+bool compressed_vector_test()
+{
+	// sorted ids over a small range pack into a few bits each
+	{
+		JC_Compressed_Vector* vec = JC_compressed_vector_construct(0);
+		assert(JC_compressed_vector_empty(vec));
+
+		for (uint64_t i = 0; i < 1000; i++)
+			assert(JC_compressed_vector_pushback(vec, 5000000000ULL + i * 3));
+
+		assert(JC_compressed_vector_size(vec) == 1000);
+		assert(JC_compressed_vector_block_count(vec) == 1000 / JC_C_COMPRESSED_VECTOR_BLOCK_SIZE + 1);
+		assert(JC_compressed_vector_compressed_bytes(vec) * 3 < 1000 * sizeof(uint64_t));
+
+		uint64_t value;
+		for (uint64_t i = 0; i < 1000; i++)
+		{
+			assert(JC_compressed_vector_get(vec, i, &value));
+			assert(value == 5000000000ULL + i * 3);
+		}
+
+		assert(!JC_compressed_vector_get(vec, 1000, &value));
+
+		// decode a range that starts and ends partway through blocks, including the uncompressed tail
+		uint64_t decoded[1000];
+		assert(JC_compressed_vector_decode(vec, 100, 900, decoded));
+		for (uint64_t i = 0; i < 900; i++)
+			assert(decoded[i] == 5000000000ULL + (i + 100) * 3);
+
+		assert(JC_compressed_vector_decode(vec, 0, 1000, decoded));
+		for (uint64_t i = 0; i < 1000; i++)
+			assert(decoded[i] == 5000000000ULL + i * 3);
+
+		assert(!JC_compressed_vector_decode(vec, 999, 2, decoded));
+
+		JC_compressed_vector_clear(vec);
+		assert(JC_compressed_vector_empty(vec));
+		assert(JC_compressed_vector_block_count(vec) == 0);
+
+		JC_compressed_vector_destruct(&vec);
+		assert(vec == NULL);
+	}
+
+	// constant blocks take no words, and full range blocks take 64 bits per value
+	{
+		JC_Compressed_Vector* vec = JC_compressed_vector_construct(0);
+
+		for (int i = 0; i < JC_C_COMPRESSED_VECTOR_BLOCK_SIZE; i++)
+			JC_compressed_vector_pushback(vec, 7);
+
+		for (int i = 0; i < JC_C_COMPRESSED_VECTOR_BLOCK_SIZE; i++)
+			JC_compressed_vector_pushback(vec, i % 2 ? UINT64_MAX : 0);
+
+		for (int i = 0; i < JC_C_COMPRESSED_VECTOR_BLOCK_SIZE; i++)
+			JC_compressed_vector_pushback(vec, 7);
+
+		// forces the last block to be packed
+		JC_compressed_vector_pushback(vec, 1);
+
+		uint64_t decoded[JC_C_COMPRESSED_VECTOR_BLOCK_SIZE];
+
+		assert(JC_compressed_vector_decode_block(vec, 0, decoded) == JC_C_COMPRESSED_VECTOR_BLOCK_SIZE);
+		for (int i = 0; i < JC_C_COMPRESSED_VECTOR_BLOCK_SIZE; i++)
+			assert(decoded[i] == 7);
+
+		assert(JC_compressed_vector_decode_block(vec, 1, decoded) == JC_C_COMPRESSED_VECTOR_BLOCK_SIZE);
+		for (int i = 0; i < JC_C_COMPRESSED_VECTOR_BLOCK_SIZE; i++)
+			assert(decoded[i] == (i % 2 ? UINT64_MAX : 0));
+
+		uint64_t value;
+		assert(JC_compressed_vector_get(vec, 2 * JC_C_COMPRESSED_VECTOR_BLOCK_SIZE + 5, &value));
+		assert(value == 7);
+
+		assert(JC_compressed_vector_decode_block(vec, 3, decoded) == 1);
+		assert(decoded[0] == 1);
+		assert(JC_compressed_vector_decode_block(vec, 4, decoded) == 0);
+
+		JC_compressed_vector_destruct(&vec);
+	}
+
+	// one block for every bit width, each holding both 0 and the largest difference so it needs exactly that width
+	{
+		JC_Compressed_Vector* vec = JC_compressed_vector_construct(64 * JC_C_COMPRESSED_VECTOR_BLOCK_SIZE);
+
+		for (size_t width = 1; width <= 64; width++)
+		{
+			uint64_t mask = width == 64 ? UINT64_MAX : ((uint64_t)1 << width) - 1;
+			uint64_t base = width == 64 ? 0 : 12345;
+
+			for (uint64_t i = 0; i < JC_C_COMPRESSED_VECTOR_BLOCK_SIZE; i++)
+				assert(JC_compressed_vector_pushback(vec, base + (i == 1 ? mask : (i * 0x9E3779B97F4A7C15ULL) & mask)));
+		}
+
+		JC_compressed_vector_pushback(vec, 0);
+		// 2 * width words per block, plus the 2 padding words
+		assert(vec->words->allocated == 64 * 65 + 2);
+
+		uint64_t decoded[JC_C_COMPRESSED_VECTOR_BLOCK_SIZE];
+
+		for (size_t width = 1; width <= 64; width++)
+		{
+			uint64_t mask = width == 64 ? UINT64_MAX : ((uint64_t)1 << width) - 1;
+			uint64_t base = width == 64 ? 0 : 12345;
+
+			assert(JC_compressed_vector_decode_block(vec, width - 1, decoded) == JC_C_COMPRESSED_VECTOR_BLOCK_SIZE);
+
+			for (uint64_t i = 0; i < JC_C_COMPRESSED_VECTOR_BLOCK_SIZE; i++)
+			{
+				uint64_t expected = base + (i == 1 ? mask : (i * 0x9E3779B97F4A7C15ULL) & mask);
+				uint64_t value;
+
+				assert(decoded[i] == expected);
+				assert(JC_compressed_vector_get(vec, (width - 1) * JC_C_COMPRESSED_VECTOR_BLOCK_SIZE + i, &value));
+				assert(value == expected);
+			}
+		}
+
+		JC_compressed_vector_destruct(&vec);
+	}
+
+	return true;
+}
+
+
+bool gather_scatter_test()
+{
+	// 4 and 8 byte elements, with enough indices to go through the prefetching loops
+	{
+		JC_Vector* ints = JC_vector_construct(200, sizeof(int));
+		JC_Vector* doubles = JC_vector_construct(200, sizeof(double));
+
+		for (int i = 0; i < 200; i++)
+		{
+			double d = i * 0.5;
+			JC_vector_pushback_ptr(ints, &i);
+			JC_vector_pushback_ptr(doubles, &d);
+		}
+
+		size_t indices[101];
+		for (int i = 0; i < 101; i++)
+			indices[i] = (i * 37) % 200;
+
+		int int_out[101];
+		double double_out[101];
+
+		assert(JC_vector_gather(ints, indices, 101, int_out));
+		assert(JC_vector_gather(doubles, indices, 101, double_out));
+
+		for (int i = 0; i < 101; i++)
+		{
+			assert(int_out[i] == (int)indices[i]);
+			assert(double_out[i] == indices[i] * 0.5);
+		}
+
+		for (int i = 0; i < 101; i++)
+			int_out[i] = -i;
+
+		assert(JC_vector_scatter(ints, indices, 101, int_out));
+
+		for (int i = 0; i < 101; i++)
+			assert(*(int*)JC_vector_at_ptr(ints, indices[i]) == -i);
+
+		// a single bad index fails the whole batch without writing anything
+		indices[50] = 200;
+		int_out[0] = 12345;
+		assert(!JC_vector_gather(ints, indices, 101, int_out));
+		assert(int_out[0] == 12345);
+		assert(!JC_vector_scatter(ints, indices, 101, int_out));
+		assert(*(int*)JC_vector_at_ptr(ints, indices[0]) == 0);
+
+		assert(JC_vector_gather(ints, indices, 0, int_out));
+
+		JC_vector_destruct(&ints);
+		JC_vector_destruct(&doubles);
+	}
+
+	// other element sizes go through the generic copy
+	{
+		JC_Vector* vec = JC_vector_construct(50, sizeof(test_struct));
+
+		for (int i = 0; i < 50; i++)
+		{
+			test_struct temp_data = { i, i * 2, i * i };
+			JC_vector_pushback_ptr(vec, &temp_data);
+		}
+
+		size_t indices[30];
+		test_struct out[30];
+
+		for (int i = 0; i < 30; i++)
+			indices[i] = 49 - i;
+
+		assert(JC_vector_gather(vec, indices, 30, out));
+
+		for (int i = 0; i < 30; i++)
+		{
+			assert(out[i].num == 49 - i);
+			assert(out[i].num_squared == (49 - i) * (49 - i));
+		}
+
+		JC_vector_destruct(&vec);
+	}
+
+	return true;
+}
+
+
+// leaves its buffers in its own thread cache and exits
+int buffer_pool_test_thread(void* unused)
+{
+	(void)unused;
+	JC_Vector* vecs[3];
+
+	for (int i = 0; i < 3; i++)
+		vecs[i] = JC_vector_construct(1000, sizeof(char));
+
+	for (int i = 0; i < 3; i++)
+		JC_vector_destruct(&vecs[i]);
+
+	return 0;
+}
+
+
+bool buffer_pool_test()
+{
+	JC_vector_pool_enable(true);
+
+	// a destructed vector's buffer and header are handed to the next vector of a similar size
+	{
+		JC_Vector* vec = JC_vector_construct(100, sizeof(int));
+
+		// pooled buffers are rounded up to a power of 2, and the vector gets the extra room
+		assert(vec->capacity == 128);
+
+		char* old_data = vec->data;
+		JC_Vector* old_header = vec;
+		JC_vector_destruct(&vec);
+
+		vec = JC_vector_construct(120, sizeof(int));
+		assert(vec == old_header);
+		assert(vec->data == old_data);
+		assert(vec->capacity == 128);
+
+		for (int i = 0; i < 500; i++)
+			JC_vector_pushback_ptr(vec, &i);
+
+		for (int i = 0; i < 500; i++)
+			assert(*(int*)JC_vector_at_ptr(vec, i) == i);
+
+		// growing recycles the old buffer as well
+		JC_Vector* small_vec = JC_vector_construct(128, sizeof(int));
+		assert(small_vec->data == old_data);
+
+		JC_vector_destruct(&small_vec);
+		JC_vector_destruct(&vec);
+	}
+
+	// buffers that were shrunk are only ever recycled into a size class they're known to fit
+	{
+		JC_Vector* vec = JC_vector_construct(100, sizeof(int));
+
+		for (int i = 0; i < 100; i++)
+			JC_vector_pushback_ptr(vec, &i);
+
+		assert(JC_vector_shrink_to_fit(vec));
+		char* old_data = vec->data;
+		JC_vector_destruct(&vec);
+
+		vec = JC_vector_construct(100, sizeof(int));
+		assert(vec->data != old_data);
+
+		JC_Vector* small_vec = JC_vector_construct(64, sizeof(int));
+		assert(small_vec->data == old_data);
+
+		JC_vector_destruct(&small_vec);
+		JC_vector_destruct(&vec);
+	}
+
+	// the thread cache spills into the shared list, which is capped
+	{
+		JC_vector_pool_trim();
+		JC_vector_pool_set_limits(2, 3);
+
+		JC_Vector* vecs[10];
+
+		for (int i = 0; i < 10; i++)
+			vecs[i] = JC_vector_construct(1000, sizeof(char));
+
+		for (int i = 0; i < 10; i++)
+			JC_vector_destruct(&vecs[i]);
+
+		// 2 buffers and 2 headers in the thread cache, 3 of each in the shared list
+		assert(JC_vector_pool_trim() == 10);
+		assert(JC_vector_pool_trim() == 0);
+
+		JC_vector_pool_set_limits(JC_C_VECTOR_POOL_DEFAULT_THREAD_LIMIT, JC_C_VECTOR_POOL_DEFAULT_SHARED_LIMIT);
+	}
+
+	// a thread's cached buffers reach the shared list when it exits instead of leaking
+	{
+		JC_vector_pool_trim();
+
+		thrd_t thread;
+		assert(thrd_create(&thread, buffer_pool_test_thread, NULL) == thrd_success);
+		thrd_join(thread, NULL);
+
+		// 3 buffers and 3 headers
+		assert(JC_vector_pool_trim() == 6);
+
+		JC_Vector* vec = JC_vector_construct(1000, sizeof(char));
+		JC_vector_destruct(&vec);
+		JC_vector_pool_flush_thread();
+		assert(JC_vector_pool_trim() == 2);
+	}
+
+	JC_vector_pool_enable(false);
+	JC_vector_pool_trim();
+
+	return true;
+}
+
+
+#define CHANNEL_TEST_COUNT 100000
+
+int channel_test_producer(void* arg)
+{
+	JC_Channel* channel = arg;
+	int next = 0;
+
+	// writes in batches straight into the ring
+	while (next < CHANNEL_TEST_COUNT)
+	{
+		size_t reserved;
+		int* slots = (int*)JC_channel_reserve(channel, 37, &reserved);
+
+		if (slots == NULL)
+		{
+			thrd_yield();
+			continue;
+		}
+
+		size_t written = 0;
+
+		for (; written < reserved && next < CHANNEL_TEST_COUNT; written++)
+			slots[written] = next++;
+
+		JC_channel_commit(channel, written);
+	}
+
+	return 0;
+}
+
+
+bool channel_test()
+{
+	// single threaded push, pop, and batches wrapping around the end of the ring
+	{
+		JC_Channel* channel = JC_channel_construct(6, sizeof(int));
+		assert(JC_channel_capacity(channel) == 8);
+		assert(JC_channel_empty(channel));
+
+		int value;
+		assert(!JC_channel_pop(channel, &value));
+
+		for (int i = 0; i < 8; i++)
+			assert(JC_channel_push(channel, &i));
+
+		assert(!JC_channel_push(channel, &value));
+		assert(JC_channel_size(channel) == 8);
+
+		for (int i = 0; i < 5; i++)
+		{
+			assert(JC_channel_pop(channel, &value));
+			assert(value == i);
+		}
+
+		// only the 5 slots until the end of the ring are contiguous, even though 5 are free
+		size_t reserved;
+		int* slots = (int*)JC_channel_reserve(channel, 8, &reserved);
+		assert(reserved == 5);
+		assert(slots != NULL);
+		slots[0] = 8;
+		slots[1] = 9;
+		JC_channel_commit(channel, 2);
+
+		slots = (int*)JC_channel_reserve(channel, 8, &reserved);
+		assert(reserved == 3);
+
+		size_t available;
+		int* read_slots = (int*)JC_channel_peek(channel, 8, &available);
+		assert(available == 3);
+		assert(read_slots[0] == 5 && read_slots[2] == 7);
+		JC_channel_release(channel, 3);
+
+		read_slots = (int*)JC_channel_peek(channel, 8, &available);
+		assert(available == 2);
+		assert(read_slots[0] == 8 && read_slots[1] == 9);
+		JC_channel_release(channel, 2);
+
+		assert(JC_channel_empty(channel));
+		assert(JC_channel_peek(channel, 1, &available) == NULL);
+		assert(available == 0);
+
+		JC_channel_destruct(&channel);
+		assert(channel == NULL);
+	}
+
+	// a producer thread and a consumer reading in place see every value once and in order
+	{
+		JC_Channel* channel = JC_channel_construct(64, sizeof(int));
+		thrd_t producer;
+
+		assert(thrd_create(&producer, channel_test_producer, channel) == thrd_success);
+
+		int expected = 0;
+
+		while (expected < CHANNEL_TEST_COUNT)
+		{
+			size_t available;
+			int* slots = (int*)JC_channel_peek(channel, 64, &available);
+
+			if (slots == NULL)
+			{
+				thrd_yield();
+				continue;
+			}
+
+			for (size_t i = 0; i < available; i++)
+				assert(slots[i] == expected++);
+
+			JC_channel_release(channel, available);
+		}
+
+		thrd_join(producer, NULL);
+		assert(JC_channel_empty(channel));
+
+		JC_channel_destruct(&channel);
+	}
+
+	return true;
+}
+
+
+bool persistent_vector_test()
+{
+	// snapshots keep seeing the values from when they were taken while the writer carries on
+	{
+		JC_Persistent_Vector* vec = JC_persistent_vector_construct(0, sizeof(int));
+
+		for (int i = 0; i < 1000; i++)
+			assert(JC_persistent_vector_pushback_ptr(vec, &i));
+
+		assert(JC_persistent_vector_size(vec) == 1000);
+
+		JC_Persistent_Version* snapshot1 = JC_persistent_vector_snapshot(vec);
+
+		int value = -1;
+		assert(JC_persistent_vector_set_ptr(vec, 10, &value));
+		assert(!JC_persistent_vector_set_ptr(vec, 1000, &value));
+
+		for (int i = 1000; i < 1100; i++)
+			JC_persistent_vector_pushback_ptr(vec, &i);
+
+		JC_Persistent_Version* snapshot2 = JC_persistent_vector_snapshot(vec);
+
+		// only the chunk that was written to got copied, the rest are still shared
+		JC_Persistent_Chunk** chunks1 = JC_persistent_version_chunks(snapshot1);
+		JC_Persistent_Chunk** chunks2 = JC_persistent_version_chunks(snapshot2);
+		assert(chunks1[0] != chunks2[0]);
+		assert(chunks1[1] == chunks2[1]);
+
+		for (int i = 0; i < 50; i++)
+			JC_persistent_vector_pop_back(vec);
+
+		assert(JC_persistent_snapshot_size(snapshot1) == 1000);
+		assert(JC_persistent_snapshot_size(snapshot2) == 1100);
+		assert(JC_persistent_vector_size(vec) == 1050);
+
+		assert(*(int*)JC_persistent_snapshot_at_ptr(snapshot1, 10) == 10);
+		assert(*(int*)JC_persistent_snapshot_at_ptr(snapshot2, 10) == -1);
+		assert(*(int*)JC_persistent_vector_at_ptr(vec, 10) == -1);
+		assert(JC_persistent_snapshot_at_ptr(snapshot1, 1000) == NULL);
+		assert(JC_persistent_vector_at_ptr(vec, 1050) == NULL);
+
+		// iterate the frozen version a chunk at a time
+		int expected = 0;
+		for (size_t chunk = 0; chunk < JC_persistent_snapshot_chunk_count(snapshot1); chunk++)
+		{
+			size_t count;
+			const int* elements = (const int*)JC_persistent_snapshot_chunk(snapshot1, chunk, &count);
+
+			for (size_t i = 0; i < count; i++, expected++)
+				assert(elements[i] == expected);
+		}
+		assert(expected == 1000);
+
+		// releasing in any order, including before the vector, frees everything
+		JC_persistent_snapshot_release(&snapshot2);
+		assert(snapshot2 == NULL);
+
+		JC_persistent_vector_destruct(&vec);
+		assert(vec == NULL);
+
+		assert(*(int*)JC_persistent_snapshot_at_ptr(snapshot1, 999) == 999);
+		JC_persistent_snapshot_release(&snapshot1);
+	}
+
+	// popping back into a shared chunk and pushing again must not write into the snapshot's chunk
+	{
+		JC_Persistent_Vector* vec = JC_persistent_vector_construct(0, sizeof(int));
+
+		for (int i = 0; i < 10; i++)
+			JC_persistent_vector_pushback_ptr(vec, &i);
+
+		JC_Persistent_Version* snapshot = JC_persistent_vector_snapshot(vec);
+
+		JC_persistent_vector_pop_back(vec);
+		int value = 42;
+		JC_persistent_vector_pushback_ptr(vec, &value);
+
+		assert(*(int*)JC_persistent_snapshot_at_ptr(snapshot, 9) == 9);
+		assert(*(int*)JC_persistent_vector_at_ptr(vec, 9) == 42);
+
+		JC_persistent_snapshot_release(&snapshot);
+		JC_persistent_vector_destruct(&vec);
+	}
+
+	return true;
+}
+
+
+void reduce_test_add_struct(void* accumulator_ptr, const void* element_ptr)
+{
+	test_struct* accumulator = accumulator_ptr;
+	const test_struct* element = element_ptr;
+
+	accumulator->num += element->num;
+	accumulator->num_doubled += element->num_doubled;
+	accumulator->num_squared += element->num_squared;
+}
+
+
+bool reduce_test()
+{
+	// numeric reductions, large enough to be split between several threads
+	{
+		JC_vector_parallel_set_threads(4);
+
+		JC_Vector* vec = JC_vector_construct(200000, sizeof(int32_t));
+		int64_t expected_sum = 0;
+
+		for (int32_t i = 0; i < 200000; i++)
+		{
+			int32_t value = (i * 7919) % 100000 - 50000;
+			JC_vector_pushback_ptr(vec, &value);
+			expected_sum += value;
+		}
+
+		assert(JC_vector_parallel_task_count(vec->allocated, JC_vector_reduce_min_per_task(vec)) > 1);
+
+		// while small vectors aren't worth starting threads for
+		JC_Vector* small_vec = JC_vector_construct(10000, sizeof(int32_t));
+		assert(JC_vector_resize(small_vec, 10000));
+		assert(JC_vector_parallel_task_count(small_vec->allocated, JC_vector_reduce_min_per_task(small_vec)) == 1);
+		JC_vector_destruct(&small_vec);
+
+		JC_Vector_Scalar result;
+		assert(JC_vector_sum(vec, JC_VECTOR_INT32, &result));
+		assert(result.i == expected_sum);
+
+		assert(JC_vector_min(vec, JC_VECTOR_INT32, &result));
+		assert(result.i == -50000);
+		assert(JC_vector_max(vec, JC_VECTOR_INT32, &result));
+		assert(result.i == 49999);
+
+		size_t index;
+		assert(JC_vector_argmin(vec, JC_VECTOR_INT32, &index));
+		assert(*(int32_t*)JC_vector_at_ptr(vec, index) == -50000);
+
+		// the first of equal values is returned, even when they're found by different threads
+		int32_t big = 1000000;
+		*(int32_t*)JC_vector_at_ptr(vec, 150000) = big;
+		*(int32_t*)JC_vector_at_ptr(vec, 190000) = big;
+		assert(JC_vector_argmax(vec, JC_VECTOR_INT32, &index));
+		assert(index == 150000);
+
+		assert(JC_vector_count(vec, &big) == 2);
+
+		size_t counts[4];
+		assert(JC_vector_histogram(vec, JC_VECTOR_INT32, -50000, 50000, 4, counts));
+		assert(counts[0] + counts[1] + counts[2] + counts[3] == 200000 - 2);
+		for (int i = 0; i < 4; i++)
+			assert(counts[i] >= 50000 - 2 && counts[i] <= 50000);
+
+		// the element type has to match the vector's type_size
+		assert(!JC_vector_sum(vec, JC_VECTOR_INT64, &result));
+		assert(!JC_vector_histogram(vec, JC_VECTOR_INT32, 5, 5, 4, counts));
+
+		JC_vector_destruct(&vec);
+		JC_vector_parallel_set_threads(0);
+	}
+
+	// floating point and empty vectors
+	{
+		JC_Vector* vec = JC_vector_construct(0, sizeof(double));
+
+		JC_Vector_Scalar result;
+		assert(JC_vector_sum(vec, JC_VECTOR_DOUBLE, &result));
+		assert(result.d == 0);
+		assert(!JC_vector_min(vec, JC_VECTOR_DOUBLE, &result));
+
+		double mean;
+		assert(!JC_vector_mean(vec, JC_VECTOR_DOUBLE, &mean));
+
+		for (int i = 1; i <= 100; i++)
+		{
+			double value = i * 0.5;
+			JC_vector_pushback_ptr(vec, &value);
+		}
+
+		assert(JC_vector_sum(vec, JC_VECTOR_DOUBLE, &result));
+		assert(result.d == 2525);
+		assert(JC_vector_mean(vec, JC_VECTOR_DOUBLE, &mean));
+		assert(mean == 25.25);
+		assert(JC_vector_max(vec, JC_VECTOR_DOUBLE, &result));
+		assert(result.d == 50);
+
+		JC_vector_destruct(&vec);
+	}
+
+	// user supplied reducer over structs
+	{
+		JC_Vector* vec = JC_vector_construct(50, sizeof(test_struct));
+
+		for (int i = 0; i < 50; i++)
+		{
+			test_struct temp_data = { i, i * 2, i * i };
+			JC_vector_pushback_ptr(vec, &temp_data);
+		}
+
+		test_struct identity = { 0, 0, 0 };
+		test_struct total;
+		assert(JC_vector_reduce(vec, &identity, reduce_test_add_struct, &total));
+
+		assert(total.num == 1225);
+		assert(total.num_doubled == 2450);
+		assert(total.num_squared == 40425);
+
+		JC_vector_destruct(&vec);
+	}
+
+	// signed sums wrap around on overflow, including when the threads' partial sums are added together
+	{
+		JC_vector_parallel_set_threads(4);
+
+		JC_Vector* vec = JC_vector_construct(100000, sizeof(int64_t));
+		int64_t value = INT64_MAX / 50000;
+
+		for (int i = 0; i < 100000; i++)
+			JC_vector_pushback_ptr(vec, &value);
+
+		assert(JC_vector_parallel_task_count(vec->allocated, JC_vector_reduce_min_per_task(vec)) > 1);
+
+		JC_Vector_Scalar result;
+		assert(JC_vector_sum(vec, JC_VECTOR_INT64, &result));
+		assert(result.i == (int64_t)((uint64_t)value * 100000));
+
+		JC_vector_destruct(&vec);
+		JC_vector_parallel_set_threads(0);
+	}
+
+	return true;
+}
+
+
+bool slot_map_test()
+{
+	JC_Slot_Map* map = JC_slot_map_construct(0, sizeof(test_struct));
+	JC_Slot_Handle handles[1000];
+
+	for (int i = 0; i < 1000; i++)
+	{
+		test_struct temp_data = { i, i * 2, i * i };
+		assert(JC_slot_map_insert_ptr(map, &temp_data, &handles[i]) != NULL);
+	}
+
+	assert(JC_slot_map_size(map) == 1000);
+
+	// erase every third element, and make sure the handles of the others still find the same element
+	for (int i = 0; i < 1000; i += 3)
+		assert(JC_slot_map_erase(map, handles[i]));
+
+	assert(JC_slot_map_size(map) == 666);
+
+	for (int i = 0; i < 1000; i++)
+	{
+		test_struct* element = (test_struct*)JC_slot_map_get(map, handles[i]);
+
+		if (i % 3 == 0)
+		{
+			assert(element == NULL);
+			assert(!JC_slot_map_erase(map, handles[i]));
+		}
+		else
+		{
+			assert(element != NULL && element->num == i && element->num_squared == i * i);
+		}
+	}
+
+	// the packed elements and their handles agree with each other
+	int total = 0;
+	for (size_t i = 0; i < JC_slot_map_size(map); i++)
+	{
+		test_struct* element = (test_struct*)JC_slot_map_data(map) + i;
+		assert(JC_slot_map_get(map, JC_slot_map_handle_at(map, i)) == (char*)element);
+		total += element->num;
+	}
+	assert(total == 499500 - 166833);
+
+	// reused slots don't bring stale handles back to life
+	JC_Slot_Handle reused;
+	test_struct temp_data = { -1, -2, 1 };
+	JC_slot_map_insert_ptr(map, &temp_data, &reused);
+
+	assert(reused.index == handles[999].index);
+	assert(!JC_slot_map_contains(map, handles[999]));
+	assert(((test_struct*)JC_slot_map_get(map, reused))->num == -1);
+
+	JC_Slot_Handle zeroed = { 0, 0 };
+	assert(JC_slot_map_get(map, zeroed) == NULL);
+
+	JC_slot_map_clear(map);
+	assert(JC_slot_map_empty(map));
+	assert(JC_slot_map_get(map, reused) == NULL);
+	assert(JC_slot_map_get(map, handles[1]) == NULL);
+
+	JC_slot_map_insert_ptr(map, &temp_data, &reused);
+	assert(JC_slot_map_size(map) == 1);
+
+	JC_slot_map_destruct(&map);
+	assert(map == NULL);
+
+	return true;
+}
+
+
+bool tombstone_vector_test()
+{
+	JC_Tombstone_Vector* vec = JC_tombstone_vector_construct(0, sizeof(int));
+	JC_tombstone_vector_set_compact_ratio(vec, 0);
+
+	for (int i = 0; i < 1000; i++)
+		assert(JC_tombstone_vector_pushback_ptr(vec, &i));
+
+	// erasing during iteration leaves every other index where it was
+	for (size_t i = JC_tombstone_vector_first_live(vec); i < JC_tombstone_vector_slots(vec); i = JC_tombstone_vector_next_live(vec, i + 1))
+	{
+		if (*(int*)JC_tombstone_vector_at_ptr(vec, i) % 3 != 0 || (i >= 128 && i < 320))
+			assert(JC_tombstone_vector_erase(vec, i));
+	}
+
+	assert(!JC_tombstone_vector_erase(vec, 1));
+	assert(!JC_tombstone_vector_erase(vec, 1000));
+	assert(JC_tombstone_vector_at_ptr(vec, 1) == NULL);
+	assert(*(int*)JC_tombstone_vector_at_ptr(vec, 999) == 999);
+
+	size_t live = 0;
+	for (size_t i = JC_tombstone_vector_first_live(vec); i < JC_tombstone_vector_slots(vec); i = JC_tombstone_vector_next_live(vec, i + 1))
+	{
+		assert(i % 3 == 0 && (i < 128 || i >= 320));
+		live++;
+	}
+
+	assert(live == JC_tombstone_vector_size(vec));
+	assert(JC_tombstone_vector_slots(vec) == 1000);
+
+	// compaction keeps the order of the live elements
+	assert(JC_tombstone_vector_compact(vec) == 1000 - live);
+	assert(JC_tombstone_vector_slots(vec) == live);
+	assert(JC_tombstone_vector_dead(vec) == 0);
+
+	int previous = -1;
+	for (size_t i = 0; i < JC_tombstone_vector_slots(vec); i++)
+	{
+		int value = *(int*)JC_tombstone_vector_at_ptr(vec, i);
+		assert(value % 3 == 0 && value > previous);
+		previous = value;
+	}
+
+	// with a ratio set, the next pushback compacts once enough has been erased
+	JC_tombstone_vector_set_compact_ratio(vec, 0.5);
+	size_t slots = JC_tombstone_vector_slots(vec);
+
+	for (size_t i = 0; i < slots / 2; i++)
+		JC_tombstone_vector_erase(vec, i);
+
+	assert(JC_tombstone_vector_needs_compaction(vec));
+	int value = -5;
+	JC_tombstone_vector_pushback_ptr(vec, &value);
+	assert(JC_tombstone_vector_slots(vec) == slots - slots / 2 + 1);
+	assert(*(int*)JC_tombstone_vector_at_ptr(vec, JC_tombstone_vector_slots(vec) - 1) == -5);
+
+	JC_tombstone_vector_clear(vec);
+	assert(JC_tombstone_vector_empty(vec));
+	assert(JC_tombstone_vector_first_live(vec) == 0);
+
+	JC_tombstone_vector_destruct(&vec);
+	assert(vec == NULL);
+
+	return true;
+}
+
+
+// every specialized element size, and one that falls back to the generic copies
+bool element_size_test()
+{
+	const size_t sizes[] = { 1, 2, 4, 8, 16, 32, 3 };
+
+	for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+	{
+		const size_t type_size = sizes[s];
+		JC_Vector* vec = JC_vector_construct(0, type_size);
+		unsigned char element[32];
+
+		for (int i = 0; i < 100; i++)
+		{
+			memset(element, i, type_size);
+			assert(JC_vector_pushback_ptr(vec, element));
+		}
+
+		// insert at 0 shifts everything up, erase at 0 shifts it back
+		memset(element, 0xEE, type_size);
+		assert(JC_vector_insert_ptr(vec, 0, element) != NULL);
+		assert(JC_vector_at_ptr(vec, 0)[type_size - 1] == (char)0xEE);
+		assert(JC_vector_at_ptr(vec, 51)[0] == 50);
+		JC_vector_erase(vec, 0);
+
+		memset(element, 0x7F, type_size);
+		assert(JC_vector_resize_ptr(vec, 150, element));
+
+		for (int i = 0; i < 150; i++)
+		{
+			char expected = i < 100 ? (char)i : 0x7F;
+			for (size_t byte = 0; byte < type_size; byte++)
+				assert(JC_vector_at_ptr(vec, i)[byte] == expected);
+		}
+
+		JC_vector_destruct(&vec);
+	}
+
+	return true;
+}
+
+
+bool numa_test()
+{
+	// placement is best effort, so these only check that the vector works the same wherever its pages end up
+	{
+		JC_Vector* vec = JC_vector_construct_numa(1000, sizeof(int), JC_VECTOR_NUMA_INTERLEAVE, JC_C_VECTOR_NUMA_ALL_NODES);
+		assert(vec != NULL);
+		assert(JC_vector_capacity(vec) >= 1000);
+		assert((uintptr_t)JC_vector_data(vec) % JC_vector_numa_page_size() == 0);
+
+		for (int i = 0; i < 1000; i++)
+			JC_vector_pushback_ptr(vec, &i);
+
+		assert(JC_vector_reserve_numa(vec, 2000, JC_VECTOR_NUMA_BIND, 1));
+		assert(JC_vector_capacity(vec) >= 2000);
+
+		for (int i = 0; i < 1000; i++)
+			assert(*(int*)JC_vector_at_ptr(vec, i) == i);
+
+		JC_vector_destruct(&vec);
+	}
+
+	// parallel resize and fill, split between several threads
+	{
+		JC_vector_parallel_set_threads(4);
+
+		JC_Vector* vec = JC_vector_construct(0, sizeof(int64_t));
+		int64_t value = -7;
+
+		assert(JC_vector_parallel_resize_ptr(vec, 60000, &value));
+		assert(JC_vector_size(vec) == 60000);
+
+		for (size_t i = 0; i < 60000; i++)
+			assert(*(int64_t*)JC_vector_at_ptr(vec, i) == -7);
+
+		assert(JC_vector_parallel_resize(vec, 30000));
+		assert(JC_vector_parallel_resize(vec, 80000));
+
+		for (size_t i = 0; i < 80000; i++)
+			assert(*(int64_t*)JC_vector_at_ptr(vec, i) == (i < 30000 ? -7 : 0));
+
+		value = 3;
+		JC_vector_parallel_fill(vec, &value);
+
+		for (size_t i = 0; i < 80000; i++)
+			assert(*(int64_t*)JC_vector_at_ptr(vec, i) == 3);
+
+		JC_vector_destruct(&vec);
+		JC_vector_parallel_set_threads(0);
+	}
+
+	// growing through a parallel resize keeps the buffer page aligned and placed the same way
+	{
+		JC_vector_parallel_set_threads(4);
+
+		JC_Vector* vec = JC_vector_construct_numa(100, sizeof(int), JC_VECTOR_NUMA_INTERLEAVE, JC_C_VECTOR_NUMA_ALL_NODES);
+		uint64_t node_mask;
+		JC_Vector_NUMA_Policy policy = JC_vector_numa_policy(JC_vector_data(vec), &node_mask);
+
+		for (int i = 0; i < 100; i++)
+			JC_vector_pushback_ptr(vec, &i);
+
+		assert(JC_vector_parallel_resize(vec, 50000));
+		assert(JC_vector_size(vec) == 50000);
+		assert((uintptr_t)JC_vector_data(vec) % JC_vector_numa_page_size() == 0);
+		assert(JC_vector_numa_policy(JC_vector_data(vec), &node_mask) == policy);
+
+		for (int i = 0; i < 50000; i++)
+			assert(*(int*)JC_vector_at_ptr(vec, i) == (i < 100 ? i : 0));
+
+		JC_vector_destruct(&vec);
+		JC_vector_parallel_set_threads(0);
+	}
+
+	// first touch spreads a buffer over every node in order, and a vector without a buffer is moved without copying
+	{
+		size_t nodes = JC_vector_numa_nodes();
+		assert(nodes >= 1);
+
+		assert(JC_vector_numa_node_of(1000, 0) == 0);
+		assert(JC_vector_numa_node_of(1000, 999) == nodes - 1);
+		for (size_t i = 1; i < 1000; i++)
+			assert(JC_vector_numa_node_of(1000, i - 1) <= JC_vector_numa_node_of(1000, i));
+
+		assert(!JC_vector_numa_run_on_node(nodes));
+
+		JC_Vector* vec = JC_vector_construct(10, sizeof(int));
+		free(JC_vector_release(vec, NULL, NULL));
+
+		assert(JC_vector_reserve_numa(vec, 100, JC_VECTOR_NUMA_DEFAULT, JC_C_VECTOR_NUMA_ALL_NODES));
+		assert(JC_vector_capacity(vec) >= 100);
+		assert(JC_vector_size(vec) == 0);
+
+		JC_vector_destruct(&vec);
+	}
+
+	return true;
+}
+
+
+typedef struct sort_test_record
+{
+	int id;
+	float weight;
+	int64_t score;
+}
+sort_test_record;
+
+
+bool radix_sort_test()
+{
+	const size_t count = 20000;
+
+	// signed keys, checking that records with equal keys keep their order
+	{
+		JC_Vector* vec = JC_vector_construct(count, sizeof(sort_test_record));
+
+		for (size_t i = 0; i < count; i++)
+		{
+			sort_test_record record = { (int)i, (float)((int)(i * 7919 % 2001) - 1000) / 8.0f, (int64_t)(i * 104729 % 1000) - 500 };
+			JC_vector_pushback_ptr(vec, &record);
+		}
+
+		assert(JC_vector_radix_sort(vec, offsetof(sort_test_record, score), sizeof(int64_t), JC_VECTOR_KEY_SIGNED));
+
+		for (size_t i = 1; i < count; i++)
+		{
+			sort_test_record* previous = (sort_test_record*)JC_vector_at_ptr(vec, i - 1);
+			sort_test_record* current = (sort_test_record*)JC_vector_at_ptr(vec, i);
+
+			assert(previous->score < current->score || (previous->score == current->score && previous->id < current->id));
+		}
+
+		// float keys, negatives included
+		assert(JC_vector_radix_sort(vec, offsetof(sort_test_record, weight), sizeof(float), JC_VECTOR_KEY_FLOAT));
+
+		for (size_t i = 1; i < count; i++)
+			assert(((sort_test_record*)JC_vector_at_ptr(vec, i - 1))->weight <= ((sort_test_record*)JC_vector_at_ptr(vec, i))->weight);
+
+		assert(((sort_test_record*)JC_vector_at_ptr(vec, 0))->weight == -125.0f);
+
+		// in place, by the id field, which brings back the original order
+		assert(JC_vector_radix_sort_in_place(vec, offsetof(sort_test_record, id), sizeof(int), JC_VECTOR_KEY_SIGNED));
+
+		for (size_t i = 0; i < count; i++)
+			assert(((sort_test_record*)JC_vector_at_ptr(vec, i))->id == (int)i);
+
+		// keys have to fit in the element, and floats have to be a float or a double
+		assert(!JC_vector_radix_sort(vec, sizeof(sort_test_record) - 4, 8, JC_VECTOR_KEY_UNSIGNED));
+		assert(!JC_vector_radix_sort(vec, 0, 2, JC_VECTOR_KEY_FLOAT));
+		assert(!JC_vector_radix_sort(vec, 0, 3, JC_VECTOR_KEY_UNSIGNED));
+
+		JC_vector_destruct(&vec);
+	}
+
+	// plain unsigned and double vectors, including sizes below the insertion sort threshold
+	{
+		const size_t sizes[] = { 0, 1, 10, 1000, 50000 };
+
+		for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+		{
+			JC_Vector* unsigned_vec = JC_vector_construct(sizes[s], sizeof(uint32_t));
+			JC_Vector* double_vec = JC_vector_construct(sizes[s], sizeof(double));
+			uint32_t state = 12345;
+
+			for (size_t i = 0; i < sizes[s]; i++)
+			{
+				state = state * 1664525 + 1013904223;
+				double value = ((double)state - 2147483648.0) / 3.0;
+
+				JC_vector_pushback_ptr(unsigned_vec, &state);
+				JC_vector_pushback_ptr(double_vec, &value);
+			}
+
+			assert(JC_vector_radix_sort(unsigned_vec, 0, sizeof(uint32_t), JC_VECTOR_KEY_UNSIGNED));
+			assert(JC_vector_radix_sort_in_place(double_vec, 0, sizeof(double), JC_VECTOR_KEY_FLOAT));
+
+			for (size_t i = 1; i < sizes[s]; i++)
+			{
+				assert(*(uint32_t*)JC_vector_at_ptr(unsigned_vec, i - 1) <= *(uint32_t*)JC_vector_at_ptr(unsigned_vec, i));
+				assert(*(double*)JC_vector_at_ptr(double_vec, i - 1) <= *(double*)JC_vector_at_ptr(double_vec, i));
+			}
+
+			JC_vector_destruct(&unsigned_vec);
+			JC_vector_destruct(&double_vec);
+		}
+	}
+
+	return true;
+}
+
+
+bool buffer_transfer_test()
+{
+	// adopt and release hand the same buffer back and forth without copying it
+	{
+		int* buffer = malloc(50 * sizeof(int));
+		for (int i = 0; i < 30; i++)
+			buffer[i] = i;
+
+		JC_Vector* vec = JC_vector_adopt(buffer, 30, 50, sizeof(int));
+		assert(vec != NULL);
+		assert((int*)JC_vector_data(vec) == buffer);
+		assert(JC_vector_size(vec) == 30 && JC_vector_capacity(vec) == 50);
+		assert(*(int*)JC_vector_at_ptr(vec, 29) == 29);
+
+		int value = 30;
+		JC_vector_pushback_ptr(vec, &value);
+
+		size_t count, capacity;
+		int* released = JC_vector_release(vec, &count, &capacity);
+		assert(released == buffer && count == 31 && capacity == 50);
+		assert(JC_vector_empty(vec) && JC_vector_data(vec) == NULL);
+
+		// a released vector grows again from nothing
+		for (int i = 0; i < 100; i++)
+			assert(JC_vector_pushback_ptr(vec, &i));
+		assert(*(int*)JC_vector_at_ptr(vec, 99) == 99);
+
+		assert(JC_vector_adopt(released, 51, 50, sizeof(int)) == NULL);
+
+		free(released);
+		JC_vector_destruct(&vec);
+	}
+
+	// splicing into an empty vector takes the source's buffer
+	{
+		JC_Vector* destination = JC_vector_construct(0, sizeof(int));
+		JC_Vector* source = JC_vector_construct(0, sizeof(int));
+
+		for (int i = 0; i < 40; i++)
+			JC_vector_pushback_ptr(source, &i);
+
+		char* source_data = JC_vector_data(source);
+		assert(JC_vector_concat(destination, source));
+		assert(JC_vector_data(destination) == source_data);
+		assert(JC_vector_size(destination) == 40 && JC_vector_empty(source));
+
+		// splicing a larger source in front of a smaller destination copies the destination's elements into the source's
+		// spare room instead, and the destination takes the source's buffer
+		for (int i = -5; i < 0; i++)
+			JC_vector_pushback_ptr(source, &i);
+
+		assert(JC_vector_reserve(destination, 100));
+		JC_vector_swap(&destination, &source);
+		source_data = JC_vector_data(source);
+
+		assert(JC_vector_splice(destination, 0, source));
+		assert(JC_vector_data(destination) == source_data);
+
+		for (int i = 0; i < 45; i++)
+			assert(*(int*)JC_vector_at_ptr(destination, i) == (i < 40 ? i : i - 45));
+
+		// everything else copies into the middle of the destination
+		for (int i = 100; i < 103; i++)
+			JC_vector_pushback_ptr(source, &i);
+
+		assert(JC_vector_splice(destination, 10, source));
+		assert(JC_vector_size(destination) == 48);
+		assert(*(int*)JC_vector_at_ptr(destination, 9) == 9);
+		assert(*(int*)JC_vector_at_ptr(destination, 10) == 100);
+		assert(*(int*)JC_vector_at_ptr(destination, 13) == 10);
+		assert(*(int*)JC_vector_at_ptr(destination, 47) == -1);
+
+		assert(!JC_vector_splice(destination, 49, source));
+
+		// splicing a vector into itself would empty it
+		assert(!JC_vector_splice(destination, 0, destination));
+		assert(!JC_vector_concat(destination, destination));
+		assert(JC_vector_size(destination) == 48);
+		assert(*(int*)JC_vector_at_ptr(destination, 47) == -1);
+
+		JC_Vector* other_type = JC_vector_construct(0, sizeof(double));
+		assert(!JC_vector_concat(destination, other_type));
+
+		JC_vector_destruct(&other_type);
+		JC_vector_destruct(&destination);
+		JC_vector_destruct(&source);
+	}
+
+	return true;
+}
+
+
+typedef struct range_split_test_context
+{
+	JC_Vector* vector;
+	atomic_size_t visited;
+	atomic_size_t calls[JC_C_VECTOR_PARALLEL_MAX_THREADS];
+}
+range_split_test_context;
+
+
+// adds 1 to every element, with the later elements made much slower so that workers have to steal from each other
+void range_split_test_task(size_t worker, size_t begin, size_t end, void* context_ptr)
+{
+	range_split_test_context* context = context_ptr;
+
+	for (size_t i = begin; i < end; i++)
+	{
+		int* element = (int*)JC_vector_at_ptr_unsafe(context->vector, i);
+		volatile int spin = 0;
+
+		for (size_t j = 0; j < (i > 200000 ? 200 : 1); j++)
+			spin++;
+
+		*element += 1;
+	}
+
+	atomic_fetch_add(&context->visited, end - begin);
+	atomic_fetch_add(&context->calls[worker], 1);
+}
+
+
+bool range_split_test()
+{
+	JC_Vector* vec = JC_vector_construct(240000, sizeof(int));
+
+	for (int i = 0; i < 240000; i++)
+		JC_vector_pushback_ptr(vec, &i);
+
+	// split by count, every inner boundary on a cache line and the ranges covering the whole vector
+	{
+		JC_Vector_Range ranges[7];
+		size_t written = JC_vector_split_count(vec, 7, ranges);
+
+		assert(written == 7);
+		assert(ranges[0].begin == 0 && ranges[6].end == 240000);
+
+		for (size_t i = 1; i < written; i++)
+		{
+			assert(ranges[i].begin == ranges[i - 1].end);
+			assert((uintptr_t)JC_vector_at_ptr(vec, ranges[i].begin) % JC_C_VECTOR_PARALLEL_CACHE_LINE == 0);
+		}
+
+		// split by bytes, capped by the amount of ranges given
+		assert(JC_vector_split_bytes(vec, 240000, ranges, 7) == 4);
+		assert(JC_vector_split_bytes(vec, 1, ranges, 7) == 7);
+
+		// halving until the pieces are smaller than a cache line
+		JC_Vector_Range range = { ranges[1].begin, ranges[1].begin + 100 };
+		JC_Vector_Range back;
+
+		assert(JC_vector_range_halve(vec, &range, &back));
+		assert(range.end == back.begin && back.end == ranges[1].begin + 100);
+		assert((uintptr_t)JC_vector_at_ptr(vec, back.begin) % JC_C_VECTOR_PARALLEL_CACHE_LINE == 0);
+
+		range.end = range.begin + 10;
+		assert(!JC_vector_range_halve(vec, &range, &back));
+	}
+
+	// work stealing parallel for
+	{
+		JC_vector_parallel_set_threads(4);
+
+		range_split_test_context context;
+		context.vector = vec;
+		atomic_init(&context.visited, 0);
+		for (size_t i = 0; i < JC_C_VECTOR_PARALLEL_MAX_THREADS; i++)
+			atomic_init(&context.calls[i], 0);
+
+		size_t workers = JC_vector_parallel_for(vec, 1000, range_split_test_task, &context);
+
+		assert(workers == 4);
+		assert(atomic_load(&context.visited) == 240000);
+
+		for (size_t i = 0; i < workers; i++)
+			assert(atomic_load(&context.calls[i]) > 0);
+
+		for (int i = 0; i < 240000; i++)
+			assert(*(int*)JC_vector_at_ptr(vec, i) == i + 1);
+
+		JC_vector_parallel_set_threads(0);
+	}
+
+	JC_vector_destruct(&vec);
+	return true;
+}
+
+
+// trims every tracked vector, including the one whose growth called it. Only safe because the test is single threaded
+size_t memory_accounting_test_trim(size_t bytes_needed, void* context)
+{
+	(void)bytes_needed;
+	(void)context;
+
+	return JC_vector_trim_all(0);
+}
+
+
+// frees the vector it's given, as a stand in for a cache that can be dropped when memory runs short
+size_t memory_accounting_test_reclaim(size_t bytes_needed, void* context)
+{
+	(void)bytes_needed;
+
+	JC_Vector** cached = context;
+	size_t freed = *cached == NULL ? 0 : JC_vector_capacity(*cached) * (*cached)->type_size;
+
+	JC_vector_destruct(cached);
+	return freed;
+}
+
+
+bool memory_accounting_test()
+{
+	const size_t baseline = JC_vector_memory_allocated();
+
+	// every vector's capacity is counted from construct to destruct
+	{
+		JC_Vector* vec = JC_vector_construct(100, sizeof(int));
+		assert(JC_vector_memory_allocated() == baseline + JC_vector_capacity(vec) * sizeof(int));
+
+		for (int i = 0; i < 1000; i++)
+			JC_vector_pushback_ptr(vec, &i);
+		assert(JC_vector_memory_allocated() == baseline + JC_vector_capacity(vec) * sizeof(int));
+
+		size_t count, capacity;
+		free(JC_vector_release(vec, &count, &capacity));
+		assert(JC_vector_memory_allocated() == baseline);
+
+		JC_vector_destruct(&vec);
+		assert(JC_vector_memory_allocated() == baseline);
+	}
+
+	// tracked vectors can have their idle capacity trimmed
+	{
+		JC_vector_memory_track(true);
+
+		JC_Vector* vec1 = JC_vector_construct(1000, sizeof(int));
+		JC_Vector* vec2 = JC_vector_construct(1000, sizeof(int));
+		JC_vector_resize(vec1, 10);
+		JC_vector_resize(vec2, 990);
+
+		JC_Vector_Memory_Stats stats = JC_vector_memory_stats();
+		assert(stats.tracked_vectors == 2);
+		assert(stats.tracked_used_bytes == 1000 * sizeof(int));
+		assert(stats.tracked_allocated_bytes == (JC_vector_capacity(vec1) + JC_vector_capacity(vec2)) * sizeof(int));
+
+		// only vec1 has enough idle capacity to be trimmed
+		size_t vec1_idle = (JC_vector_capacity(vec1) - 10) * sizeof(int);
+		assert(JC_vector_trim_all(1000) == vec1_idle);
+		assert(JC_vector_capacity(vec1) == 10);
+		assert(JC_vector_capacity(vec2) >= 1000);
+
+		JC_vector_destruct(&vec1);
+		JC_vector_destruct(&vec2);
+		assert(JC_vector_memory_stats().tracked_vectors == 0);
+
+		JC_vector_memory_track(false);
+	}
+
+	// growth past the budget calls the reclaimers, and fails if they can't free enough
+	{
+		JC_Vector* cached = JC_vector_construct(2000, sizeof(int));
+		JC_vector_memory_set_budget(JC_vector_memory_allocated() + 8000 * sizeof(int));
+		assert(JC_vector_memory_add_reclaimer(memory_accounting_test_reclaim, &cached));
+
+		JC_Vector* vec = JC_vector_construct(0, sizeof(int));
+		int pushed = 0;
+
+		while (pushed < 20000 && JC_vector_pushback_ptr(vec, &pushed))
+			pushed++;
+
+		assert(cached == NULL);
+		assert(pushed < 20000);
+		assert(JC_vector_memory_allocated() <= baseline + 10000 * sizeof(int));
+		assert(JC_vector_construct(10000, sizeof(int)) == NULL);
+
+		JC_vector_destruct(&vec);
+		JC_vector_memory_set_budget(0);
+		JC_vector_memory_clear_reclaimers();
+	}
+
+	// a reclaimer may trim the very vector that is growing, which must still leave the count right
+	{
+		JC_vector_memory_track(true);
+
+		JC_Vector* vec = JC_vector_construct(4000, sizeof(int));
+		for (int i = 0; i < 10; i++)
+			JC_vector_pushback_ptr(vec, &i);
+
+		JC_vector_memory_set_budget(JC_vector_memory_allocated() + 1000 * sizeof(int));
+		assert(JC_vector_memory_add_reclaimer(memory_accounting_test_trim, NULL));
+
+		assert(JC_vector_reserve(vec, 8000));
+		assert(JC_vector_memory_allocated() == baseline + JC_vector_capacity(vec) * sizeof(int));
+		assert(*(int*)JC_vector_at_ptr(vec, 9) == 9);
+
+		JC_vector_destruct(&vec);
+		JC_vector_memory_set_budget(0);
+		JC_vector_memory_clear_reclaimers();
+		JC_vector_memory_track(false);
+	}
+
+	assert(JC_vector_memory_allocated() == baseline);
+
+	return true;
+}
+
+
+bool sparse_vector_test()
+{
+	// a large index space only pays for the blocks that are written to
+	{
+		JC_Sparse_Vector* vec = JC_sparse_vector_construct(10000000, sizeof(int64_t), NULL);
+		assert(vec != NULL);
+		assert(JC_sparse_vector_size(vec) == 10000000);
+		assert(JC_sparse_vector_block_count(vec) == 0);
+		assert(*(int64_t*)JC_sparse_vector_get(vec, 1234567) == 0);
+		assert(JC_sparse_vector_get(vec, 10000000) == NULL);
+
+		size_t ids[] = { 5, 7, 300, 9999999, 1234567, 1234568 };
+		for (size_t i = 0; i < sizeof(ids) / sizeof(ids[0]); i++)
+		{
+			int64_t value = (int64_t)ids[i] * 3;
+			assert(JC_sparse_vector_set(vec, ids[i], &value));
+		}
+
+		int64_t value = 1;
+		assert(!JC_sparse_vector_set(vec, 10000000, &value));
+
+		assert(JC_sparse_vector_non_default_count(vec) == 6);
+		assert(JC_sparse_vector_block_count(vec) == 4);
+		assert(*(int64_t*)JC_sparse_vector_get(vec, 300) == 900);
+		assert(*(int64_t*)JC_sparse_vector_get(vec, 301) == 0);
+		assert(!JC_sparse_vector_is_default(vec, 9999999));
+		assert(JC_sparse_vector_is_default(vec, 9999998));
+
+		// only non default entries are visited, in index order
+		size_t expected[] = { 5, 7, 300, 1234567, 1234568, 9999999 };
+		size_t visited = 0;
+		for (size_t i = JC_sparse_vector_first(vec); i < JC_sparse_vector_size(vec); i = JC_sparse_vector_next(vec, i + 1))
+		{
+			assert(i == expected[visited]);
+			assert(*(int64_t*)JC_sparse_vector_get(vec, i) == (int64_t)i * 3);
+			visited++;
+		}
+		assert(visited == 6);
+
+		// setting the default back frees the storage once a whole block is default again
+		assert(JC_sparse_vector_reset(vec, 5));
+		assert(JC_sparse_vector_block_count(vec) == 4);
+		value = 0;
+		assert(JC_sparse_vector_set(vec, 7, &value));
+		assert(JC_sparse_vector_block_count(vec) == 3);
+		assert(JC_sparse_vector_non_default_count(vec) == 4);
+		assert(JC_sparse_vector_first(vec) == 300);
+		assert(*(int64_t*)JC_sparse_vector_get(vec, 1234568) == 1234568 * 3);
+
+		// shrinking drops everything past the new end
+		assert(JC_sparse_vector_resize(vec, 1234568));
+		assert(JC_sparse_vector_non_default_count(vec) == 2);
+		assert(JC_sparse_vector_block_count(vec) == 2);
+		assert(JC_sparse_vector_next(vec, 301) == 1234567);
+		assert(JC_sparse_vector_next(vec, 1234568) == 1234568);
+
+		// and growing again brings back only default elements
+		assert(JC_sparse_vector_resize(vec, 20000000));
+		assert(JC_sparse_vector_is_default(vec, 9999999));
+		assert(JC_sparse_vector_next(vec, 1234568) == 20000000);
+		value = 42;
+		assert(JC_sparse_vector_set(vec, 19999999, &value));
+		assert(JC_sparse_vector_set(vec, 100, &value));
+		assert(*(int64_t*)JC_sparse_vector_get(vec, 300) == 900);
+		assert(*(int64_t*)JC_sparse_vector_get(vec, 100) == 42);
+		assert(JC_sparse_vector_next(vec, 1234568) == 19999999);
+
+		JC_sparse_vector_clear(vec);
+		assert(JC_sparse_vector_block_count(vec) == 0);
+		assert(JC_sparse_vector_non_default_count(vec) == 0);
+		assert(JC_sparse_vector_first(vec) == JC_sparse_vector_size(vec));
+
+		JC_sparse_vector_destruct(&vec);
+		assert(vec == NULL);
+	}
+
+	// blocks added in any order stay findable, with a default other than zero
+	{
+		const int missing = -1;
+		JC_Sparse_Vector* vec = JC_sparse_vector_construct(200000, sizeof(int), &missing);
+
+		for (int i = 199999; i >= 0; i -= 997)
+			assert(JC_sparse_vector_set(vec, (size_t)i, &i));
+
+		size_t count = 0;
+		for (size_t i = 0; i < 200000; i++)
+		{
+			int stored = *(int*)JC_sparse_vector_get(vec, i);
+
+			if ((199999 - i) % 997 == 0)
+			{
+				assert(stored == (int)i);
+				count++;
+			}
+			else
+				assert(stored == -1);
+		}
+		assert(count == JC_sparse_vector_non_default_count(vec));
+
+		for (size_t i = JC_sparse_vector_first(vec); i < JC_sparse_vector_size(vec); i = JC_sparse_vector_next(vec, i + 1))
+		{
+			assert(JC_sparse_vector_reset(vec, i));
+			count--;
+		}
+		assert(count == 0);
+		assert(JC_sparse_vector_block_count(vec) == 0);
+
+		JC_sparse_vector_destruct(&vec);
+	}
+
+	// blocks come and go across several superblocks, and the ones left stay in order
+	{
+		const size_t block_total = JC_C_SPARSE_VECTOR_SUPERBLOCK_BLOCKS * 3 + 5;
+		JC_Sparse_Vector* vec = JC_sparse_vector_construct(block_total * JC_C_SPARSE_VECTOR_BLOCK_ELEMENTS, sizeof(size_t), NULL);
+
+		for (size_t block = block_total; block-- > 0;)
+		{
+			size_t index = block * JC_C_SPARSE_VECTOR_BLOCK_ELEMENTS + block % JC_C_SPARSE_VECTOR_BLOCK_ELEMENTS;
+			size_t value = block + 1;
+			assert(JC_sparse_vector_set(vec, index, &value));
+		}
+		assert(JC_sparse_vector_block_count(vec) == block_total);
+
+		// empty every odd block, which leaves every superblock half full
+		for (size_t block = 1; block < block_total; block += 2)
+			assert(JC_sparse_vector_reset(vec, block * JC_C_SPARSE_VECTOR_BLOCK_ELEMENTS + block % JC_C_SPARSE_VECTOR_BLOCK_ELEMENTS));
+		assert(JC_sparse_vector_block_count(vec) == (block_total + 1) / 2);
+
+		size_t block = 0;
+		for (size_t i = JC_sparse_vector_first(vec); i < JC_sparse_vector_size(vec); i = JC_sparse_vector_next(vec, i + 1), block += 2)
+		{
+			assert(i == block * JC_C_SPARSE_VECTOR_BLOCK_ELEMENTS + block % JC_C_SPARSE_VECTOR_BLOCK_ELEMENTS);
+			assert(*(size_t*)JC_sparse_vector_get(vec, i) == block + 1);
+		}
+		assert(block == block_total + 1);
+
+		// dropping the last superblock and a half frees their blocks
+		assert(JC_sparse_vector_resize(vec, JC_C_SPARSE_VECTOR_SUPERBLOCK_BLOCKS * 3 / 2 * JC_C_SPARSE_VECTOR_BLOCK_ELEMENTS));
+		assert(JC_sparse_vector_block_count(vec) == JC_C_SPARSE_VECTOR_SUPERBLOCK_BLOCKS * 3 / 4);
+		assert(JC_sparse_vector_resize(vec, block_total * JC_C_SPARSE_VECTOR_BLOCK_ELEMENTS));
+		assert(JC_sparse_vector_set(vec, JC_sparse_vector_size(vec) - 1, &block));
+		assert(JC_sparse_vector_block_count(vec) == JC_C_SPARSE_VECTOR_SUPERBLOCK_BLOCKS * 3 / 4 + 1);
+
+		JC_sparse_vector_destruct(&vec);
+	}
+
+	return true;
+}
+
+
+
+
+
+int main() {
+	
+	assert(JC_vector_max_size() == JC_C_VECTOR_MAX_SIZE);
+
+	// Tests for the first implementation. Type independant via pointers, and no object oriented support
+	assert(construct_test());
+	assert(push_and_pop_test());
+	assert(grow_and_shrink_test());
+	assert(insert_test());
+	assert(erase_test());
+	assert(erase_if_test());
+	assert(are_same_test());
+	assert(swap_test());
+	assert(resize_test());
+
+	assert(bit_vector_test());
+	assert(compressed_vector_test());
+	assert(gather_scatter_test());
+	assert(buffer_pool_test());
+	assert(channel_test());
+	assert(persistent_vector_test());
+	assert(reduce_test());
+	assert(slot_map_test());
+	assert(tombstone_vector_test());
+	assert(element_size_test());
+	assert(numa_test());
+	assert(radix_sort_test());
+	assert(buffer_transfer_test());
+	assert(range_split_test());
+	assert(memory_accounting_test());
+	assert(sparse_vector_test());
 
 	return 0;
 }